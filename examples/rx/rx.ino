@@ -22,19 +22,32 @@
 
 #include <Manchester.h>
 #include <RadioPacket.h>
-#include <string.h>
+#include <FrameRing.h>
+#include <MessageView.h>
+#include <RadioPacketView.h>
 
-using RadioPacket;
+using RadioPacket::FrameRing;
+using RadioPacket::Message;
+using RadioPacket::MessageView;
+using RadioPacket::RadioPacketView;
 
 const uint8_t RX_PIN = 3;
 const uint32_t SERIAL_BAUD = 115200;
-const uint8_t BUFFER_SIZE = 0xff;
 
-uint8_t buffer[BUFFER_SIZE] = {0};
+//frames are received into one slot while earlier ones are parsed from
+//the others, so a burst is not lost while loop() is busy printing
+FrameRing<4> frames;
+uint8_t* slot = nullptr;
+
+void receiveNext() {
+
+	//if every slot is still waiting to be parsed, try again next loop()
+	slot = frames.claim();
+
+	if(slot != nullptr) {
+		man.beginReceiveArray(frames.getSlotSize(), slot);
+	}
 
-void resetBuffer() {
-	::memset(buffer, 0, BUFFER_SIZE);
-	man.beginReceiveArray(BUFFER_SIZE, buffer);
 }
 
 void setup() {
@@ -46,29 +59,41 @@ void setup() {
 	}
 
 	Serial.begin(SERIAL_BAUD);
-	man.setupTransmit(TX_PIN, MAN_600);
-	resetBuffer();
+	man.setupReceive(RX_PIN, MAN_600);
+	receiveNext();
 
 }
 
 void loop() {
 
-	if(!man.receiveComplete()) {
+	//hand the completed frame over and start receiving the next one
+	//before doing any parsing
+	if(slot != nullptr && man.receiveComplete()) {
+		frames.commit(frames.getSlotSize());
+		slot = nullptr;
+	}
+
+	if(slot == nullptr) {
+		receiveNext();
+	}
+
+	size_t len;
+	const uint8_t* const frame = frames.front(&len);
+
+	if(frame == nullptr) {
 		return;
 	}
 
-	RadioPacket* p;
-	Message* m;
+	//parse in place; the slot is not reused until it is released
+	RadioPacketView p;
+	MessageView m;
 
-	if(RadioPacket::parse(&p, buffer, BUFFER_SIZE) == RadioPacket::PARSE_OK) {
-		if(Message::parse(&m, p->getBodyData(), p->getRawBodyLength()) == Message::PARSE_OK) {
-			Serial.println(m->getBodyData());
+	if(RadioPacketView::parse(&p, frame, len) == RadioPacket::RadioPacket::PARSE_OK) {
+		if(p.getMessage(&m) == Message::PARSE_OK) {
+			Serial.println(m.getRawAction());
 		}
 	}
 
-	delete p;
-	delete m;
-
-	resetBuffer();
+	frames.release();
 
 }
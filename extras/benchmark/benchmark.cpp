@@ -0,0 +1,496 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Host benchmark for the library's hot paths.
+ *
+ * Each operation is run repeatedly across a range of payload sizes for at
+ * least the minimum time (default 50ms) and reported as JSON on stdout:
+ * nanoseconds and operations per second, and heap allocations and bytes
+ * allocated per operation.
+ *
+ * 	radiopacket-benchmark [min-time-ms] [name-filter]
+ */
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <new>
+
+#include "Compression.h"
+#include "Crc.h"
+#include "FecCodec.h"
+#include "Fragmenter.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "PacketEncoder.h"
+#include "RadioPacket.h"
+#include "RadioPacketView.h"
+#include "Reassembler.h"
+#include "SampleBatchMessage.h"
+#include "Util.h"
+
+using RadioPacket::Compression;
+using RadioPacket::Decompressor;
+using RadioPacket::FecCodec;
+using RadioPacket::Fragmenter;
+using RadioPacket::Message;
+using RadioPacket::MessageView;
+using RadioPacket::PacketEncoder;
+using RadioPacket::RadioPacketView;
+using RadioPacket::Reassembler;
+using RadioPacket::SampleBatchMessage;
+using RadioPacket::Util;
+
+typedef RadioPacket::RadioPacket Packet;
+
+/**
+ * Every allocation in the process is counted
+ */
+static size_t allocCount = 0;
+static size_t allocBytes = 0;
+
+void* operator new(const size_t n) {
+	++allocCount;
+	allocBytes += n;
+	if(void* const p = std::malloc(n == 0 ? 1 : n)) {
+		return p;
+	}
+	throw std::bad_alloc();
+}
+
+void* operator new[](const size_t n) {
+	return ::operator new(n);
+}
+
+void operator delete(void* const p) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* const p) noexcept {
+	std::free(p);
+}
+
+void operator delete(void* const p, const size_t) noexcept {
+	std::free(p);
+}
+
+void operator delete[](void* const p, const size_t) noexcept {
+	std::free(p);
+}
+
+/**
+ * Stop the compiler from discarding a result
+ */
+template<class T>
+static inline void keep(const T& v) {
+	asm volatile("" : : "g"(&v) : "memory");
+}
+
+typedef std::chrono::steady_clock Clock;
+
+static double minTimeNs = 50e6;
+static const char* filter = nullptr;
+static bool firstResult = true;
+
+/**
+ * Run op(payload) until minTimeNs has passed and print a JSON result
+ */
+template<class Op>
+static void run(const char* const name, const size_t payload, Op op) {
+
+	if(filter != nullptr && std::strstr(name, filter) == nullptr) {
+		return;
+	}
+
+	//warm up
+	op();
+
+	uint64_t iterations = 0;
+	uint64_t batch = 16;
+	size_t allocs = 0;
+	size_t bytes = 0;
+	double elapsed = 0;
+
+	while(elapsed < minTimeNs) {
+
+		const size_t allocsBefore = allocCount;
+		const size_t bytesBefore = allocBytes;
+		const Clock::time_point start = Clock::now();
+
+		for(uint64_t i = 0; i < batch; ++i) {
+			op();
+		}
+
+		elapsed += std::chrono::duration<double, std::nano>(Clock::now() - start).count();
+		allocs += allocCount - allocsBefore;
+		bytes += allocBytes - bytesBefore;
+		iterations += batch;
+		batch *= 2;
+
+	}
+
+	const double ns = elapsed / iterations;
+
+	std::printf(
+		"%s\n\t\t{\"name\": \"%s\", \"payload\": %zu, \"iterations\": %llu, "
+		"\"ns_per_op\": %.2f, \"ops_per_sec\": %.0f, "
+		"\"allocs_per_op\": %.2f, \"bytes_per_op\": %.2f}",
+		firstResult ? "" : ",",
+		name,
+		payload,
+		static_cast<unsigned long long>(iterations),
+		ns,
+		1e9 / ns,
+		static_cast<double>(allocs) / iterations,
+		static_cast<double>(bytes) / iterations);
+
+	firstResult = false;
+
+}
+
+static const size_t PAYLOADS[] = { 0, 1, 8, 16, 32, 64, 128, 192, 242, 246 };
+static const size_t LARGE_PAYLOADS[] = { 246, 1024, 4096, 16384 };
+
+static uint8_t data[16384];
+
+static void benchmarkCrc() {
+
+	for(const size_t len : PAYLOADS) {
+
+		run("Util::crc8", len, [len]() {
+			keep(Util::crc8(0, data, len));
+		});
+
+		run("Util::crc16", len, [len]() {
+			keep(Util::crc16(0xffff, data, len));
+		});
+
+		run("Util::crc8_slow", len, [len]() {
+			keep(Util::crc8_slow(0, data, len));
+		});
+
+		run("Util::crc8_fast", len, [len]() {
+			keep(Util::crc8_fast(0, data, len));
+		});
+
+		run("Crc8Ccitt::updateBitwise", len, [len]() {
+			keep(RadioPacket::Crc8Ccitt::updateBitwise(0, data, len));
+		});
+
+	}
+
+}
+
+static void benchmarkPacket() {
+
+	for(const size_t len : PAYLOADS) {
+
+		Packet p(data, static_cast<uint8_t>(len));
+		p.setRawCrc8(p.generateChecksum());
+
+		uint8_t frame[Packet::getMaxPacketLength()];
+		std::memcpy(frame, p.getData(), p.getRawPacketLength());
+		const uint8_t frameLen = p.getRawPacketLength();
+
+		run("RadioPacket::parse", len, [&]() {
+			Packet* parsed;
+			Packet::parse(&parsed, frame, frameLen);
+			keep(parsed);
+			delete parsed;
+		});
+
+		run("RadioPacketView::parse", len, [&]() {
+			RadioPacketView v;
+			RadioPacketView::parse(&v, frame, frameLen);
+			keep(v);
+		});
+
+		//header changes only; the body's CRC stays cached
+		run("RadioPacket::generateChecksum", len, [&]() {
+			p.setRawReceiverId(static_cast<uint16_t>(frame[0]));
+			keep(p.generateChecksum());
+		});
+
+		run("RadioPacketView::generateChecksum", len, [&]() {
+			RadioPacketView v;
+			RadioPacketView::parse(&v, frame, frameLen);
+			keep(v.generateChecksum());
+		});
+
+	}
+
+}
+
+static void benchmarkMessage() {
+
+	for(const size_t len : PAYLOADS) {
+
+		if(len > PacketEncoder::getMaxPayloadLength()) {
+			continue;
+		}
+
+		Message m(data, static_cast<uint16_t>(len));
+		const uint8_t* const msg = m.getData();
+		const uint16_t msgLen = m.getMessageLength();
+
+		run("Message::parse", len, [&]() {
+			Message* parsed;
+			Message::parse(&parsed, msg, msgLen);
+			keep(parsed);
+			delete parsed;
+		});
+
+		run("MessageView::parse", len, [&]() {
+			MessageView v;
+			MessageView::parse(&v, msg, msgLen);
+			keep(v);
+		});
+
+		run("Message+RadioPacket encode", len, [&]() {
+			Message em(data, static_cast<uint16_t>(len));
+			em.setRawAction(1);
+			Packet p(&em);
+			p.setRawCrc8(p.generateChecksum());
+			keep(*p.getData());
+		});
+
+		run("PacketEncoder::encodeMessage", len, [&]() {
+			uint8_t buff[Packet::getMaxPacketLength()];
+			PacketEncoder e;
+			keep(e.encodeMessage(buff, 1, data, static_cast<uint8_t>(len)));
+			keep(buff);
+		});
+
+	}
+
+}
+
+static void benchmarkFragmentation() {
+
+	static Reassembler<1, sizeof(data) + Message::getHeaderLength()> reassembler;
+
+	for(const size_t len : LARGE_PAYLOADS) {
+
+		Message m(data, static_cast<uint16_t>(len));
+		uint8_t frames[80][Packet::getMaxPacketLength()];
+		uint8_t frameLens[80];
+		size_t frameCount = 0;
+
+		Fragmenter f(&m);
+		while((frameLens[frameCount] = f.next(frames[frameCount])) > 0) {
+			++frameCount;
+		}
+
+		run("Fragmenter::next", len, [&]() {
+			uint8_t buff[Packet::getMaxPacketLength()];
+			Fragmenter fr(&m);
+			while(fr.next(buff) > 0) {
+				keep(buff);
+			}
+		});
+
+		run("Reassembler::accept", len, [&]() {
+			MessageView v;
+			for(size_t i = 0; i < frameCount; ++i) {
+				RadioPacketView p;
+				RadioPacketView::parse(&p, frames[i], frameLens[i]);
+				keep(reassembler.accept(p, 0, &v));
+			}
+		});
+
+		//the legacy defragment expects packets in order, in an array
+		Packet* packets[80];
+		for(size_t i = 0; i < frameCount; ++i) {
+			Packet::parse(&packets[i], frames[i], frameLens[i]);
+		}
+
+		run("RadioPacket::defragment", len, [&]() {
+			static uint8_t out[sizeof(data) + Message::getHeaderLength()];
+			keep(Packet::defragment(packets, static_cast<uint8_t>(frameCount), out));
+		});
+
+		for(size_t i = 0; i < frameCount; ++i) {
+			delete packets[i];
+		}
+
+	}
+
+}
+
+static void benchmarkCompression() {
+
+	//slowly changing little-endian readings, as a sensor would send
+	static uint8_t readings[Packet::getMaxPacketLength()];
+
+	for(size_t i = 0; i + 1 < sizeof(readings); i += 2) {
+		readings[i] = static_cast<uint8_t>(0x40 + (i / 32));
+		readings[i + 1] = 0x01;
+	}
+
+	static const uint8_t codecs[] = {
+		Compression::CODEC_RUN_LENGTH,
+		Compression::CODEC_LZ
+	};
+
+	for(const size_t len : PAYLOADS) {
+		for(const uint8_t codec : codecs) {
+
+			const bool lz = codec == Compression::CODEC_LZ;
+			uint8_t compressed[Packet::getMaxPacketLength()];
+			const size_t compressedLen = Compression::compress(
+				codec, readings, len, compressed, sizeof(compressed));
+
+			run(lz ? "Compression::compress LZ" : "Compression::compress RLE", len, [&]() {
+				uint8_t out[Packet::getMaxPacketLength()];
+				keep(Compression::compress(codec, readings, len, out, sizeof(out)));
+				keep(out);
+			});
+
+			if(compressedLen == 0) {
+				continue;
+			}
+
+			run(lz ? "Decompressor::decode LZ" : "Decompressor::decode RLE", len, [&]() {
+				static Decompressor d;
+				uint8_t out[Packet::getMaxPacketLength()];
+				size_t consumed;
+				d.reset();
+				keep(d.decode(compressed, compressedLen, &consumed, out, sizeof(out)));
+				keep(out);
+			});
+
+		}
+	}
+
+}
+
+static void benchmarkSampleBatch() {
+
+	for(const size_t len : PAYLOADS) {
+
+		//too short for the batch header
+		if(len < 8) {
+			continue;
+		}
+
+		//a slowly wandering reading; deltas of -4 to 4 pack into 4 bits
+		const auto fill = [](SampleBatchMessage& b) {
+			uint16_t v = 512;
+			for(uint16_t i = 0; b.add(v); ++i) {
+				v = static_cast<uint16_t>(v + (i * 7919) % 9 - 4);
+			}
+		};
+
+		SampleBatchMessage batch(1, static_cast<uint16_t>(len));
+		fill(batch);
+
+		run("SampleBatchMessage::add", len, [&]() {
+			batch.clear();
+			fill(batch);
+			keep(batch);
+		});
+
+		run("SampleBatchMessage::decode", len, [&]() {
+			uint16_t samples[2048];
+			uint16_t count;
+			keep(SampleBatchMessage::decode(
+				batch.getBodyData(),
+				batch.getRawBodyLength(),
+				samples,
+				2048,
+				&count));
+			keep(samples);
+		});
+
+	}
+
+}
+
+static void benchmarkFec() {
+
+	typedef FecCodec<8, 2> Fec;
+
+	PacketEncoder e;
+
+	for(const size_t len : PAYLOADS) {
+
+		uint8_t frame[Fec::getMaxFrameLength()];
+		uint8_t corrupt[Fec::getMaxFrameLength()];
+		const uint8_t packetLen = e.encode(frame, data, static_cast<uint8_t>(len));
+		const uint16_t frameLen = Fec::encode(frame, packetLen);
+
+		run("FecCodec::encode", len, [&]() {
+			keep(Fec::encode(frame, packetLen));
+		});
+
+		//the common case; no errors to correct
+		run("FecCodec::decode", len, [&]() {
+			uint8_t n;
+			keep(Fec::decode(frame, frameLen, &n));
+		});
+
+		//the most each codeword can correct, in one burst
+		run("FecCodec::decode (8 byte burst)", len, [&]() {
+			uint8_t n;
+			std::memcpy(corrupt, frame, frameLen);
+			for(uint16_t i = 0; i < 8; ++i) {
+				corrupt[frameLen / 2 + i] ^= 0x5a;
+			}
+			keep(Fec::decode(corrupt, frameLen, &n));
+		});
+
+	}
+
+}
+
+int main(const int argc, const char* const argv[]) {
+
+	if(argc > 1) {
+		minTimeNs = std::atof(argv[1]) * 1e6;
+	}
+
+	if(argc > 2) {
+		filter = argv[2];
+	}
+
+	for(size_t i = 0; i < sizeof(data); ++i) {
+		data[i] = static_cast<uint8_t>(i * 131 + 7);
+	}
+
+	std::printf("{\n\t\"compiler\": \"%s\",\n\t\"min_time_ms\": %.0f,\n\t\"benchmarks\": [", __VERSION__, minTimeNs / 1e6);
+
+	benchmarkCrc();
+	benchmarkPacket();
+	benchmarkMessage();
+	benchmarkFragmentation();
+	benchmarkCompression();
+	benchmarkSampleBatch();
+	benchmarkFec();
+
+	std::printf("\n\t]\n}\n");
+
+	return 0;
+
+}
@@ -0,0 +1,111 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+/**
+ * Host gateway example.
+ *
+ * Reads a raw byte stream from stdin, as received from a radio or serial
+ * link, finds the packets in it and prints one line per packet. Built as
+ * C++17 against the radiopacket static library.
+ *
+ * 	radiopacket-gateway < capture.bin
+ */
+
+#include <cstdint>
+#include <cstdio>
+
+#include "MessageAggregate.h"
+#include "MessageView.h"
+#include "RadioPacketView.h"
+#include "StreamDeframer.h"
+
+using RadioPacket::AggregateIterator;
+using RadioPacket::Message;
+using RadioPacket::MessageView;
+using RadioPacket::RadioPacketView;
+using RadioPacket::StreamDeframer;
+
+static void print(const RadioPacketView& v) {
+
+	std::printf("tx=%u rx=%u fragment=%u body=%u",
+		v.getRawTransmitterId(),
+		v.getRawReceiverId(),
+		v.getRawFragmentNumber(),
+		v.getRawBodyLength());
+
+	if(v.getFormat()->hasSequenceNumber()) {
+		std::printf(" seq=%u message=%u",
+			v.getRawSequenceNumber(),
+			v.getRawMessageId());
+	}
+
+	MessageView m;
+
+	if(AggregateIterator::isAggregate(v)) {
+
+		AggregateIterator it(v);
+
+		while(it.next(&m)) {
+			std::printf(" action=%u", m.getRawAction());
+		}
+
+	}
+	else if(v.getMessage(&m) == Message::PARSE_OK) {
+		std::printf(" action=%u", m.getRawAction());
+	}
+
+	std::printf("\n");
+
+}
+
+int main() {
+
+	StreamDeframer<1024> deframer;
+	RadioPacketView v;
+	uint8_t buff[256];
+	size_t len;
+
+	while((len = std::fread(buff, 1, sizeof(buff), stdin)) > 0) {
+
+		//the ring may fill before all of buff is written; drain it and
+		//write the rest
+		for(size_t written = 0; written < len; ) {
+
+			written += deframer.write(buff + written, len - written);
+
+			while(deframer.next(&v)) {
+				print(v);
+			}
+
+		}
+
+	}
+
+	std::fprintf(stderr, "%u packets, %u bytes skipped, %u checksum errors\n",
+		static_cast<unsigned>(deframer.getFrameCount()),
+		static_cast<unsigned>(deframer.getSkippedByteCount()),
+		static_cast<unsigned>(deframer.getChecksumErrorCount()));
+
+	return 0;
+
+}
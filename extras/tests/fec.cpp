@@ -0,0 +1,272 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * Host regression tests for ReedSolomon and FecCodec.
+ *
+ * Random codewords are corrupted in chosen numbers of bytes, and frames
+ * in bursts, from a fixed seed so that every run checks the same cases.
+ * Exits with a nonzero status on the first failure.
+ *
+ * 	radiopacket-test-fec
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "FecCodec.h"
+#include "PacketEncoder.h"
+#include "RadioPacketView.h"
+#include "ReedSolomon.h"
+
+using namespace RadioPacket;
+
+#define CHECK(c) do { \
+	if(!(c)) { \
+		std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); \
+		return 1; \
+	} \
+} while(0)
+
+static uint32_t state = 0x2545f491;
+
+static uint32_t next() {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static void fill(uint8_t* const data, const size_t len) {
+	for(size_t i = 0; i < len; ++i) {
+		data[i] = static_cast<uint8_t>(next());
+	}
+}
+
+/**
+ * Corrupt n distinct bytes of a codeword laid out as data then parity,
+ * each stride bytes apart
+ */
+static void corrupt(
+	uint8_t* const codeword,
+	const uint8_t len,
+	const uint8_t stride,
+	const uint8_t n) {
+
+		bool hit[0xff] = { false };
+
+		for(uint8_t k = 0; k < n; ) {
+
+			const uint8_t i = static_cast<uint8_t>(next() % len);
+
+			if(hit[i]) {
+				continue;
+			}
+
+			hit[i] = true;
+			codeword[i * stride] ^= static_cast<uint8_t>(1 + next() % 0xff);
+			++k;
+
+		}
+
+}
+
+/**
+ * Up to ParityLength / 2 corrupted bytes are corrected, wherever they are
+ */
+template<uint8_t ParityLength, uint8_t Stride>
+static int testCorrection() {
+
+	static uint8_t codeword[0xff * Stride];
+	static uint8_t original[0xff * Stride];
+
+	for(int run = 0; run < 2000; ++run) {
+
+		const uint8_t len = static_cast<uint8_t>(next() % (0x100 - ParityLength));
+		const uint8_t errors = static_cast<uint8_t>(next() % (ParityLength / 2 + 1));
+		uint8_t* const parity = codeword + len * Stride;
+		uint8_t corrected = 0xff;
+
+		fill(codeword, sizeof(codeword));
+		ReedSolomon::encode(codeword, len, parity, ParityLength, Stride);
+		std::memcpy(original, codeword, sizeof(codeword));
+
+		CHECK(ReedSolomon::decode(codeword, len, parity, ParityLength, Stride, &corrected) ==
+			ReedSolomon::DECODE_OK);
+		CHECK(corrected == 0);
+
+		corrupt(codeword, len + ParityLength, Stride, errors);
+
+		CHECK(ReedSolomon::decode(codeword, len, parity, ParityLength, Stride, &corrected) ==
+			ReedSolomon::DECODE_OK);
+		CHECK(corrected == errors);
+		CHECK(std::memcmp(codeword, original, sizeof(codeword)) == 0);
+
+	}
+
+	return 0;
+
+}
+
+/**
+ * One more corrupted byte than can be corrected is reported as such,
+ * and the codeword is left as received. A decoder may rarely mistake it
+ * for another codeword, so only nearly all need be caught.
+ */
+template<uint8_t ParityLength>
+static int testUncorrectable() {
+
+	static const int RUNS = 2000;
+
+	uint8_t codeword[0xff];
+	uint8_t received[0xff];
+	int detected = 0;
+
+	for(int run = 0; run < RUNS; ++run) {
+
+		const uint8_t len = static_cast<uint8_t>(ParityLength + next() % (0x100 - 2 * ParityLength));
+		uint8_t* const parity = codeword + len;
+
+		fill(codeword, sizeof(codeword));
+		ReedSolomon::encode(codeword, len, parity, ParityLength);
+		corrupt(codeword, len + ParityLength, 1, ParityLength / 2 + 1);
+		std::memcpy(received, codeword, sizeof(codeword));
+
+		if(ReedSolomon::decode(codeword, len, parity, ParityLength) ==
+			ReedSolomon::DECODE_ERROR_UNCORRECTABLE) {
+				CHECK(std::memcmp(codeword, received, sizeof(codeword)) == 0);
+				++detected;
+		}
+
+	}
+
+	CHECK(detected >= RUNS * 9 / 10);
+
+	return 0;
+
+}
+
+/**
+ * A burst of Depth * ParityLength / 2 bytes is corrected wherever it
+ * starts in the frame
+ */
+template<uint8_t ParityLength, uint8_t Depth>
+static int testBurst() {
+
+	typedef FecCodec<ParityLength, Depth> Fec;
+
+	static const uint16_t BURST_LEN = Depth * (ParityLength / 2);
+
+	uint8_t frame[Fec::getMaxFrameLength()];
+	uint8_t original[Fec::getMaxFrameLength()];
+	uint8_t body[0xff];
+	PacketEncoder e;
+
+	fill(body, sizeof(body));
+
+	for(uint8_t bodyLen = 0; bodyLen <= e.getMaxBodyLength(); bodyLen += 17) {
+
+		const uint8_t len = e.encode(frame, body, bodyLen);
+
+		if(len > Fec::getMaxPacketLength()) {
+			CHECK(Fec::encode(frame, len) == 0);
+			continue;
+		}
+
+		const uint16_t frameLen = Fec::encode(frame, len);
+		CHECK(frameLen == len + Fec::getParityLength());
+		std::memcpy(original, frame, frameLen);
+
+		for(uint16_t at = 0; at + BURST_LEN <= frameLen; ++at) {
+
+			uint8_t packetLen = 0;
+			uint16_t corrected = 0;
+			RadioPacketView v;
+
+			for(uint16_t i = 0; i < BURST_LEN; ++i) {
+				frame[at + i] ^= static_cast<uint8_t>(1 + next() % 0xff);
+			}
+
+			CHECK(Fec::decode(frame, frameLen, &packetLen, &corrected) == ReedSolomon::DECODE_OK);
+			CHECK(packetLen == len && corrected == BURST_LEN);
+			CHECK(std::memcmp(frame, original, frameLen) == 0);
+			CHECK(RadioPacketView::parse(&v, frame, packetLen) ==
+				::RadioPacket::RadioPacket::PARSE_OK);
+
+		}
+
+	}
+
+	return 0;
+
+}
+
+/**
+ * Frames no longer than the parity, or longer than the longest frame, are
+ * rejected; so are codewords Reed-Solomon cannot represent
+ */
+static int testInvalidLength() {
+
+	typedef FecCodec<8, 2> Fec;
+
+	uint8_t frame[Fec::getMaxFrameLength() + 1] = { 0 };
+	uint8_t len;
+
+	CHECK(Fec::decode(frame, 0, &len) == ReedSolomon::DECODE_ERROR_INVALID_LENGTH);
+	CHECK(Fec::decode(frame, Fec::getParityLength(), &len) ==
+		ReedSolomon::DECODE_ERROR_INVALID_LENGTH);
+	CHECK(Fec::decode(frame, Fec::getMaxFrameLength() + 1, &len) ==
+		ReedSolomon::DECODE_ERROR_INVALID_LENGTH);
+	CHECK(Fec::encode(frame, 0xff) == Fec::getMaxFrameLength());
+
+	typedef FecCodec<8, 1> Shallow;
+
+	CHECK(Shallow::encode(frame, Shallow::getMaxPacketLength() + 1) == 0);
+	CHECK(ReedSolomon::decode(frame, 250, frame + 250, 6) ==
+		ReedSolomon::DECODE_ERROR_INVALID_LENGTH);
+	CHECK(ReedSolomon::decode(frame, 10, frame + 10, 0) ==
+		ReedSolomon::DECODE_ERROR_INVALID_LENGTH);
+
+	return 0;
+
+}
+
+int main() {
+
+	if(testCorrection<2, 1>() != 0 ||
+		testCorrection<8, 1>() != 0 ||
+		testCorrection<8, 3>() != 0 ||
+		testCorrection<32, 1>() != 0 ||
+		testUncorrectable<8>() != 0 ||
+		testUncorrectable<16>() != 0 ||
+		testBurst<8, 2>() != 0 ||
+		testBurst<8, 1>() != 0 ||
+		testBurst<16, 3>() != 0 ||
+		testInvalidLength() != 0) {
+			return 1;
+	}
+
+	std::printf("ok\n");
+	return 0;
+
+}
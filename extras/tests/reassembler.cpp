@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * Host regression tests for Reassembler.
+ *
+ * Version 1 and 3 packets carry no message ID, so consecutive messages from
+ * a transmitter share a reassembly slot. These tests check that fragments
+ * left over from an incomplete message are not mistaken for the next one.
+ * Exits with a nonzero status on the first failure.
+ *
+ * 	radiopacket-test-reassembler
+ */
+
+#include <cstdio>
+#include <cstring>
+#include "Fragmenter.h"
+#include "Reassembler.h"
+#include "RadioPacketView.h"
+
+using namespace RadioPacket;
+
+#define CHECK(c) do { \
+	if(!(c)) { \
+		std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); \
+		return 1; \
+	} \
+} while(0)
+
+static const size_t MAX_FRAGMENTS = 8;
+static const uint8_t NO_DROP = 0xfe;
+
+struct Fragments {
+	uint8_t data[MAX_FRAGMENTS][255];
+	uint8_t len[MAX_FRAGMENTS];
+	size_t count;
+};
+
+static void fillBody(uint8_t* const body, const size_t len, const uint8_t seed) {
+	for(size_t i = 0; i < len; ++i) {
+		body[i] = (uint8_t)(seed + i * 7);
+	}
+}
+
+static bool fragment(
+	Fragments* const out,
+	const uint8_t* const body,
+	const size_t len,
+	const uint8_t version,
+	const bool parity) {
+
+		Message m;
+		m.setBodyData(body, len);
+
+		Fragmenter f(&m);
+		f.setRawVersion(version);
+		f.setRawTransmitterId(42);
+		f.setParity(parity);
+
+		out->count = 0;
+
+		while(f.hasNext()) {
+			if(out->count == MAX_FRAGMENTS) {
+				return false;
+			}
+			out->len[out->count] = f.next(out->data[out->count]);
+			if(out->len[out->count] == 0) {
+				return false;
+			}
+			++out->count;
+		}
+
+		return true;
+
+}
+
+/**
+ * Feeds fragments to the reassembler, skipping drop, and returns the result
+ * of the last one
+ */
+template <typename R>
+static uint8_t deliver(
+	R& r,
+	const Fragments& frags,
+	const size_t drop,
+	MessageView* const m) {
+
+		uint8_t result = R::ACCEPT_INCOMPLETE;
+
+		for(size_t i = 0; i < frags.count; ++i) {
+
+			if(i == drop) {
+				continue;
+			}
+
+			RadioPacketView v;
+
+			if(RadioPacketView::parse(&v, frags.data[i], frags.len[i]) !=
+				::RadioPacket::RadioPacket::PARSE_OK) {
+					return R::ACCEPT_ERROR_INVALID_FRAGMENT;
+			}
+
+			result = r.accept(v, 0, m);
+
+		}
+
+		return result;
+
+}
+
+static bool bodyEquals(
+	const MessageView& m,
+	const uint8_t* const body,
+	const size_t len) {
+		return m.getRawBodyLength() == len &&
+			std::memcmp(m.getBodyData(), body, len) == 0;
+}
+
+/**
+ * Message A loses its last fragment; message B from the same transmitter
+ * must then complete with its own bytes
+ */
+static int testLostLastFragment(const uint8_t version) {
+
+	Reassembler<2, 1024> r;
+	static uint8_t a[600];
+	static uint8_t b[600];
+	static Fragments fa;
+	static Fragments fb;
+	MessageView m;
+
+	fillBody(a, sizeof(a), 1);
+	fillBody(b, sizeof(b), 2);
+
+	CHECK(fragment(&fa, a, sizeof(a), version, false));
+	CHECK(fragment(&fb, b, sizeof(b), version, false));
+	CHECK(fa.count == 3 && fb.count == 3);
+
+	CHECK(deliver(r, fa, 2, &m) == r.ACCEPT_INCOMPLETE);
+	CHECK(deliver(r, fb, NO_DROP, &m) == r.ACCEPT_COMPLETE);
+	CHECK(bodyEquals(m, b, sizeof(b)));
+
+	return 0;
+
+}
+
+/**
+ * A repeated fragment with the same content is still a duplicate
+ */
+static int testDuplicate() {
+
+	Reassembler<2, 1024> r;
+	static uint8_t a[600];
+	static Fragments fa;
+	RadioPacketView v;
+	MessageView m;
+
+	fillBody(a, sizeof(a), 3);
+
+	CHECK(fragment(&fa, a, sizeof(a), 1, false));
+	CHECK(RadioPacketView::parse(&v, fa.data[0], fa.len[0]) ==
+		::RadioPacket::RadioPacket::PARSE_OK);
+	CHECK(r.accept(v, 0, &m) == r.ACCEPT_INCOMPLETE);
+	CHECK(r.accept(v, 0, &m) == r.ACCEPT_DUPLICATE);
+	CHECK(deliver(r, fa, 0, &m) == r.ACCEPT_COMPLETE);
+	CHECK(bodyEquals(m, a, sizeof(a)));
+
+	return 0;
+
+}
+
+/**
+ * Message A loses its last fragment and its parity; message B loses one data
+ * fragment and must be recovered from its own parity
+ */
+static int testParity(const uint8_t version, const size_t drop) {
+
+	Reassembler<2, 1024, true> r;
+	static uint8_t a[600];
+	static uint8_t b[600];
+	static Fragments fa;
+	static Fragments fb;
+	MessageView m;
+
+	fillBody(a, sizeof(a), 4);
+	fillBody(b, sizeof(b), 5);
+
+	CHECK(fragment(&fa, a, sizeof(a), version, true));
+	CHECK(fragment(&fb, b, sizeof(b), version, true));
+	CHECK(fa.count == 4 && fb.count == 4);
+
+	// deliver A's first two fragments only
+	fa.count = 2;
+
+	CHECK(deliver(r, fa, NO_DROP, &m) == r.ACCEPT_INCOMPLETE);
+	CHECK(deliver(r, fb, drop, &m) == r.ACCEPT_COMPLETE);
+	CHECK(bodyEquals(m, b, sizeof(b)));
+
+	return 0;
+
+}
+
+/**
+ * An unparseable packet is rejected rather than reassembled
+ */
+static int testUnparseable() {
+
+	Reassembler<2, 1024> r;
+	uint8_t body[20] = { 0 };
+	MessageView m;
+
+	::RadioPacket::RadioPacket p(body, sizeof(body));
+	uint8_t* const data = const_cast<uint8_t*>(p.getData());
+
+	// body length no longer matches the packet length
+	data[7] = 100;
+	p.setRawCrc8(p.generateChecksum());
+
+	CHECK(r.accept(p, 0, &m) == r.ACCEPT_ERROR_INVALID_FRAGMENT);
+
+	RadioPacketView v;
+	CHECK(r.accept(v, 0, &m) == r.ACCEPT_ERROR_INVALID_FRAGMENT);
+
+	return 0;
+
+}
+
+int main() {
+
+	if(testLostLastFragment(1) != 0 ||
+		testLostLastFragment(3) != 0 ||
+		testDuplicate() != 0 ||
+		testParity(1, 0) != 0 ||
+		testParity(1, 1) != 0 ||
+		testParity(3, 2) != 0 ||
+		testUnparseable() != 0) {
+			return 1;
+	}
+
+	std::printf("ok\n");
+	return 0;
+
+}
@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+/**
+ * Host regression tests for SampleBatchMessage decoding.
+ *
+ * Batches of every delta width and a range of sample counts, including
+ * counts which are not multiples of eight, are decoded and compared with
+ * the samples added. Built twice: once as the library is configured,
+ * which on x86-64 hosts with AVX2 unpacks eight deltas at a time, and
+ * once with RADIOPACKET_NO_SIMD, so that both paths are checked. Exits
+ * with a nonzero status on the first failure.
+ *
+ * 	radiopacket-test-samples
+ * 	radiopacket-test-samples-no-simd
+ */
+
+#include <cstdio>
+#include "SampleBatchMessage.h"
+
+using namespace RadioPacket;
+
+#define CHECK(c) do { \
+	if(!(c)) { \
+		std::printf("FAIL %s:%d: %s\n", __FILE__, __LINE__, #c); \
+		return 1; \
+	} \
+} while(0)
+
+static const uint16_t MAX_SAMPLES = 1000;
+static const uint8_t MAX_WIDTH = 17;
+
+static uint32_t state = 0x9e3779b9;
+
+static uint32_t next() {
+	state ^= state << 13;
+	state ^= state >> 17;
+	state ^= state << 5;
+	return state;
+}
+
+static int32_t zigzagDecode(const uint32_t zz) {
+	return (zz & 1) ? -static_cast<int32_t>((zz + 1) >> 1) : static_cast<int32_t>(zz >> 1);
+}
+
+/**
+ * Add count samples whose widest difference is width bits, decode the
+ * batch, and compare
+ */
+static int testBatch(const uint8_t width, const uint16_t count) {
+
+	static uint16_t expected[MAX_SAMPLES];
+	static uint16_t decoded[MAX_SAMPLES];
+
+	SampleBatchMessage batch(1, 0x1000);
+
+	//the first difference is the full width: zigzag codes of width bits
+	//run from 2^(width - 1) up, and from the middle of the range any
+	//difference of up to 16 bits fits. A 17 bit difference only fits
+	//downwards from the top, so is made negative (an odd code).
+	int32_t sample = width == MAX_WIDTH ? 0xffff : 0x8000;
+	uint32_t zz = 0;
+
+	if(width == MAX_WIDTH) {
+		zz = (0x10000 + next() % 0xffff) | 1;
+	}
+	else if(width > 0) {
+		zz = (1UL << (width - 1)) + next() % (1UL << (width - 1));
+	}
+
+	//later differences are narrower, and short of the largest code of
+	//their width, so that negating one to stay in range keeps it within
+	//the width
+	const uint8_t rest = width < 16 ? width : 16;
+	const uint32_t restCodes = rest > 0 ? (1UL << rest) - 1 : 1;
+
+	for(uint16_t i = 0; i < count; ++i) {
+
+		if(i > 0) {
+
+			int32_t d = zigzagDecode(i == 1 ? zz : next() % restCodes);
+
+			if(sample + d < 0 || sample + d > 0xffff) {
+				d = -d;
+			}
+
+			sample += d;
+
+		}
+
+		expected[i] = static_cast<uint16_t>(sample);
+		CHECK(batch.add(expected[i]));
+
+	}
+
+	CHECK(batch.getSampleCount() == count);
+	CHECK(count < 2 || batch.getWidth() == width);
+
+	uint16_t n = 0;
+
+	CHECK(SampleBatchMessage::decode(
+		batch.getBodyData(),
+		batch.getRawBodyLength(),
+		decoded,
+		MAX_SAMPLES,
+		&n) == SampleBatchMessage::DECODE_OK);
+	CHECK(n == count);
+
+	for(uint16_t i = 0; i < count; ++i) {
+		CHECK(decoded[i] == expected[i]);
+	}
+
+	return 0;
+
+}
+
+int main() {
+
+	static const uint16_t COUNTS[] = {
+		1, 2, 7, 8, 9, 15, 16, 17, 24, 31, 33, 64, 100, 255, 257, MAX_SAMPLES
+	};
+
+	for(uint8_t width = 0; width <= MAX_WIDTH; ++width) {
+		for(size_t i = 0; i < sizeof(COUNTS) / sizeof(COUNTS[0]); ++i) {
+			for(int run = 0; run < 20; ++run) {
+				if(testBatch(width, COUNTS[i]) != 0) {
+					std::printf("width %u, %u samples\n", width, COUNTS[i]);
+					return 1;
+				}
+			}
+		}
+	}
+
+	std::printf("ok\n");
+	return 0;
+
+}
@@ -0,0 +1,437 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef ACTION_DISPATCH_H_35E2FC7D_FC96_4CA3_936E_241A3820567D
+#define ACTION_DISPATCH_H_35E2FC7D_FC96_4CA3_936E_241A3820567D
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Allocator.h"
+#include "MessageView.h"
+#include "Meta.h"
+#include "Platform.h"
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	#include <avr/pgmspace.h>
+#endif
+
+/**
+ * Constant-time dispatch of messages to handlers by action.
+ *
+ * A handler is a type naming the MessageSchema it accepts and a static
+ * function to call with a view of each matching message:
+ *
+ * 	struct OnMotion {
+ * 		typedef MotionMessage Schema;
+ * 		static void handle(const MessageView& m, App& app) {
+ * 			app.move(MotionMessage::get<1>(m, 0));
+ * 		}
+ * 	};
+ *
+ * Handlers are only called for messages whose body is long enough for
+ * their schema, so they can read fields without checking. Use
+ * AnyMessage<Action> as the schema to accept any body.
+ *
+ * Two dispatchers share the same handlers:
+ *
+ * 	ActionTable<App, OnMotion, OnBeacon>	| the table is built at compile
+ * 											| time and indexed by action;
+ * 											| for MCUs
+ * 	ActionRegistry<App>						| handlers are added at
+ * 											| runtime to a two-level table;
+ * 											| for hosts with many actions
+ *
+ * Messages with no handler, or too short for their handler, are counted
+ * and not passed on. Counters are not synchronised; dispatch from one
+ * context.
+ */
+namespace RadioPacket {
+
+/**
+ * A handler function and the shortest body it accepts
+ */
+template<class Context>
+struct ActionEntry {
+	void (*handler)(const MessageView& m, Context& c);
+	uint16_t minBodyLength;
+};
+
+/**
+ * Stands in for a MessageSchema to accept every message with Action,
+ * whatever its body
+ */
+template<uint16_t Action>
+struct AnyMessage {
+
+	static const uint16_t ACTION = Action;
+
+	static constexpr uint16_t getBodyLength() noexcept {
+		return 0;
+	}
+
+};
+
+template<uint16_t Action>
+const uint16_t AnyMessage<Action>::ACTION;
+
+/**
+ * Dispatch results and counters common to ActionTable and ActionRegistry
+ */
+template<class Context>
+class ActionDispatcher {
+
+protected:
+
+	uint32_t _dispatched = 0;
+	uint32_t _unknown = 0;
+	uint32_t _tooShort = 0;
+
+	uint8_t _invoke(
+		const ActionEntry<Context>* const e,
+		const MessageView& m,
+		Context& c) noexcept {
+
+			if(e == nullptr || e->handler == nullptr) {
+				++this->_unknown;
+				return DISPATCH_UNKNOWN_ACTION;
+			}
+
+			if(m.getRawBodyLength() < e->minBodyLength) {
+				++this->_tooShort;
+				return DISPATCH_BODY_TOO_SHORT;
+			}
+
+			++this->_dispatched;
+			e->handler(m, c);
+
+			return DISPATCH_OK;
+
+	}
+
+
+public:
+
+	static const uint8_t DISPATCH_OK = 0;
+	static const uint8_t DISPATCH_UNKNOWN_ACTION = 1;
+	static const uint8_t DISPATCH_BODY_TOO_SHORT = 2;
+
+	/**
+	 * Number of messages passed to a handler
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getDispatchedCount() const noexcept {
+		return this->_dispatched;
+	}
+
+	/**
+	 * Number of messages with no handler for their action
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getUnknownActionCount() const noexcept {
+		return this->_unknown;
+	}
+
+	/**
+	 * Number of messages too short for their handler's schema
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getBodyTooShortCount() const noexcept {
+		return this->_tooShort;
+	}
+
+	void resetCounts() noexcept {
+		this->_dispatched = 0;
+		this->_unknown = 0;
+		this->_tooShort = 0;
+	}
+
+};
+
+template<class Context>
+const uint8_t ActionDispatcher<Context>::DISPATCH_OK;
+
+template<class Context>
+const uint8_t ActionDispatcher<Context>::DISPATCH_UNKNOWN_ACTION;
+
+template<class Context>
+const uint8_t ActionDispatcher<Context>::DISPATCH_BODY_TOO_SHORT;
+
+/**
+ * Compile-time helpers for ActionTable
+ */
+template<uint16_t Action, class... Handlers>
+struct ActionLookup {
+	static const bool FOUND = false;
+	template<class Context>
+	static constexpr ActionEntry<Context> entry() noexcept {
+		return ActionEntry<Context>{ nullptr, 0 };
+	}
+};
+
+template<uint16_t Action, class H, class... Hs>
+struct ActionLookup<Action, H, Hs...> {
+
+	static const bool FOUND = H::Schema::ACTION == Action ||
+		ActionLookup<Action, Hs...>::FOUND;
+
+	template<class Context>
+	static constexpr ActionEntry<Context> entry() noexcept {
+		return H::Schema::ACTION == Action
+			? ActionEntry<Context>{ &H::handle, H::Schema::getBodyLength() }
+			: ActionLookup<Action, Hs...>::template entry<Context>();
+	}
+
+};
+
+template<class... Handlers>
+struct ActionRange;
+
+template<class H>
+struct ActionRange<H> {
+	static const uint16_t MIN = H::Schema::ACTION;
+	static const uint16_t MAX = H::Schema::ACTION;
+	static const bool UNIQUE = true;
+};
+
+template<class H, class... Hs>
+struct ActionRange<H, Hs...> {
+
+	static const uint16_t MIN = H::Schema::ACTION < ActionRange<Hs...>::MIN
+		? H::Schema::ACTION
+		: ActionRange<Hs...>::MIN;
+
+	static const uint16_t MAX = H::Schema::ACTION > ActionRange<Hs...>::MAX
+		? H::Schema::ACTION
+		: ActionRange<Hs...>::MAX;
+
+	static const bool UNIQUE = ActionRange<Hs...>::UNIQUE &&
+		!ActionLookup<H::Schema::ACTION, Hs...>::FOUND;
+
+};
+
+template<class Context, uint16_t Min, class Indices, class... Handlers>
+struct ActionTableData;
+
+template<class Context, uint16_t Min, size_t... I, class... Handlers>
+struct ActionTableData<Context, Min, Meta::IndexSequence<I...>, Handlers...> {
+	static constexpr ActionEntry<Context> TABLE[sizeof...(I)] RADIOPACKET_PROGMEM = {
+		ActionLookup<static_cast<uint16_t>(Min + I), Handlers...>::template entry<Context>()...
+	};
+};
+
+template<class Context, uint16_t Min, size_t... I, class... Handlers>
+constexpr ActionEntry<Context> ActionTableData<Context, Min, Meta::IndexSequence<I...>, Handlers...>::TABLE[sizeof...(I)] RADIOPACKET_PROGMEM;
+
+/**
+ * Dispatcher whose table is built at compile time. The table has one
+ * entry for every action between the lowest and highest handled, so
+ * handled actions should be close together; the span is limited to 256.
+ * Each entry is a function pointer and a length: 4 bytes on AVR, where the
+ * table is kept in flash, and 16 bytes on a 64 bit host.
+ *
+ * 	ActionTable<App, OnMotion, OnBeacon> table;
+ * 	table.dispatch(view, app);
+ */
+template<class Context, class... Handlers>
+class ActionTable : public ActionDispatcher<Context> {
+
+	static_assert(sizeof...(Handlers) > 0, "ActionTable needs at least one handler");
+	static_assert(ActionRange<Handlers...>::UNIQUE,
+		"ActionTable has more than one handler for an action");
+	static_assert(ActionRange<Handlers...>::MAX - ActionRange<Handlers...>::MIN < 256,
+		"ActionTable actions are too far apart; use an ActionRegistry");
+
+protected:
+
+	static const uint16_t _MIN = ActionRange<Handlers...>::MIN;
+	static const uint16_t _SPAN = ActionRange<Handlers...>::MAX - _MIN + 1;
+
+	typedef ActionTableData<
+		Context,
+		_MIN,
+		typename Meta::MakeIndexSequence<_SPAN>::Type,
+		Handlers...> _Data;
+
+
+public:
+
+	/**
+	 * Pass m to the handler for its action. Returns one of the
+	 * DISPATCH_* constants.
+	 * @param  {MessageView&} m :
+	 * @param  {Context&} c     : passed through to the handler
+	 * @return {uint8_t}        :
+	 */
+	uint8_t dispatch(const MessageView& m, Context& c) noexcept {
+
+		//actions below the lowest wrap around to large indices
+		const uint16_t i = static_cast<uint16_t>(m.getRawAction() - _MIN);
+
+		if(i >= _SPAN) {
+			return this->_invoke(nullptr, m, c);
+		}
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		ActionEntry<Context> e;
+		::memcpy_P(&e, &_Data::TABLE[i], sizeof(e));
+		return this->_invoke(&e, m, c);
+#else
+		return this->_invoke(&_Data::TABLE[i], m, c);
+#endif
+
+	}
+
+};
+
+/**
+ * Dispatcher whose handlers are added at runtime, for any number of
+ * actions anywhere in the 16 bit range. The table has two levels, indexed
+ * by the high and then the low byte of the action; each second-level page
+ * of 256 entries is allocated, through RADIOPACKET_ALLOCATOR(ActionRegistry),
+ * when a handler is first added to it. The first level alone is 256
+ * pointers, so this is meant for hosts; use an ActionTable on an MCU.
+ *
+ * 	ActionRegistry<App> registry;
+ * 	registry.add<OnMotion>();
+ * 	registry.dispatch(view, app);
+ */
+template<class Context>
+class ActionRegistry : public ActionDispatcher<Context> {
+
+protected:
+
+	typedef ActionEntry<Context> _Entry;
+	typedef RADIOPACKET_ALLOCATOR(ActionRegistry) _Allocator;
+
+	static const uint16_t _PAGE_LEN = 256;
+
+	_Entry* _pages[_PAGE_LEN] = {};
+
+
+public:
+
+	ActionRegistry() noexcept = default;
+
+	ActionRegistry(const ActionRegistry& r) = delete;
+	ActionRegistry& operator=(const ActionRegistry& r) = delete;
+
+	~ActionRegistry() noexcept {
+		for(uint16_t i = 0; i < _PAGE_LEN; ++i) {
+			_Allocator::deallocate(this->_pages[i], _PAGE_LEN * sizeof(_Entry));
+		}
+	}
+
+	/**
+	 * Add Handler for its schema's action, replacing any existing
+	 * handler. Returns false if the table could not be allocated.
+	 * @return {bool}  :
+	 */
+	template<class Handler>
+	bool add() noexcept {
+		return this->add(
+			Handler::Schema::ACTION,
+			&Handler::handle,
+			Handler::Schema::getBodyLength());
+	}
+
+	/**
+	 * Add a handler function for action, replacing any existing handler.
+	 * Returns false if the table could not be allocated.
+	 * @param  {uint16_t} action        :
+	 * @param  {void(*)(...)} handler   :
+	 * @param  {uint16_t} minBodyLength : shorter messages are not passed on
+	 * @return {bool}                   :
+	 */
+	bool add(
+		const uint16_t action,
+		void (*handler)(const MessageView& m, Context& c),
+		const uint16_t minBodyLength = 0) noexcept {
+
+			_Entry*& page = this->_pages[action >> 8];
+
+			if(page == nullptr) {
+
+				page = static_cast<_Entry*>(_Allocator::allocate(_PAGE_LEN * sizeof(_Entry)));
+
+				if(page == nullptr) {
+					return false;
+				}
+
+				::memset(page, 0, _PAGE_LEN * sizeof(_Entry));
+
+			}
+
+			page[action & 0xff].handler = handler;
+			page[action & 0xff].minBodyLength = minBodyLength;
+
+			return true;
+
+	}
+
+	/**
+	 * Remove the handler for action, if any
+	 * @param  {uint16_t} action :
+	 */
+	void remove(const uint16_t action) noexcept {
+
+		_Entry* const page = this->_pages[action >> 8];
+
+		if(page != nullptr) {
+			page[action & 0xff].handler = nullptr;
+		}
+
+	}
+
+	/**
+	 * Returns true if a handler has been added for action
+	 * @param  {uint16_t} action :
+	 * @return {bool}            :
+	 */
+	bool contains(const uint16_t action) const noexcept {
+		const _Entry* const page = this->_pages[action >> 8];
+		return page != nullptr && page[action & 0xff].handler != nullptr;
+	}
+
+	/**
+	 * Pass m to the handler for its action. Returns one of the
+	 * DISPATCH_* constants.
+	 * @param  {MessageView&} m :
+	 * @param  {Context&} c     : passed through to the handler
+	 * @return {uint8_t}        :
+	 */
+	uint8_t dispatch(const MessageView& m, Context& c) noexcept {
+
+		const uint16_t action = m.getRawAction();
+		const _Entry* const page = this->_pages[action >> 8];
+
+		return this->_invoke(page != nullptr ? &page[action & 0xff] : nullptr, m, c);
+
+	}
+
+};
+
+};
+
+#endif
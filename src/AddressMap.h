@@ -0,0 +1,167 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef ADDRESS_MAP_H_A1F81EA8_D86A_4953_A7E8_BB7CA8E49111
+#define ADDRESS_MAP_H_A1F81EA8_D86A_4953_A7E8_BB7CA8E49111
+
+#include <stdint.h>
+
+#include "PacketLayout.h"
+
+/**
+ * An AddressMap pairs the 16 bit IDs of up to Capacity nodes with the 8
+ * bit short addresses that a compact (version 3) header carries. Every
+ * node of a network is configured with the same map, eg. from a table
+ * built into its firmware:
+ *
+ * 	AddressMap<4> map;
+ * 	map.add(1, GATEWAY_ID);
+ * 	map.add(2, KITCHEN_ID);
+ *
+ * 	uint8_t address;
+ * 	if(map.toAddress(KITCHEN_ID, &address)) {
+ * 		encoder.setRawVersion(3);
+ * 		encoder.setRawTransmitterId(address);
+ * 	}
+ *
+ * Broadcast maps to broadcast (PacketFormat::BROADCAST_ID and
+ * PacketFormat::BROADCAST_ADDRESS) without an entry, and
+ * PacketFormat::UNASSIGNED_ADDRESS is never mapped, so short addresses
+ * run from 1 to 254. Setters take broadcast as BROADCAST_ID; they reject
+ * BROADCAST_ADDRESS like any other value too large for a short address.
+ * Lookups are linear, which for the few nodes of one network is faster
+ * than anything else on an MCU and needs only three bytes per node.
+ */
+namespace RadioPacket {
+template<uint8_t Capacity>
+class AddressMap {
+
+	static_assert(Capacity > 0 && Capacity < PacketFormat::BROADCAST_ADDRESS,
+		"AddressMap capacity must be between 1 and 254");
+
+protected:
+
+	struct Entry {
+		uint16_t id;
+		uint8_t address;
+	};
+
+	Entry _entries[Capacity];
+	uint8_t _count = 0;
+
+
+public:
+
+	AddressMap() noexcept {
+	}
+
+	/**
+	 * Pair a short address with an ID. Returns false if the map is full,
+	 * either is already mapped, either is broadcast, or the address is
+	 * PacketFormat::UNASSIGNED_ADDRESS.
+	 * @param  {uint8_t} address :
+	 * @param  {uint16_t} id     :
+	 * @return {bool}            :
+	 */
+	bool add(const uint8_t address, const uint16_t id) noexcept {
+
+		uint8_t a;
+		uint16_t i;
+
+		if(this->_count == Capacity ||
+			address == PacketFormat::BROADCAST_ADDRESS ||
+			address == PacketFormat::UNASSIGNED_ADDRESS ||
+			id == PacketFormat::BROADCAST_ID ||
+			this->toAddress(id, &a) ||
+			this->toId(address, &i)) {
+				return false;
+		}
+
+		this->_entries[this->_count].id = id;
+		this->_entries[this->_count].address = address;
+		++this->_count;
+
+		return true;
+
+	}
+
+	/**
+	 * Short address of an ID
+	 * @param  {uint16_t} id        :
+	 * @param  {uint8_t*} const     :
+	 * @return {bool}               : false if id is not mapped
+	 */
+	bool toAddress(const uint16_t id, uint8_t* const address) const noexcept {
+
+		if(id == PacketFormat::BROADCAST_ID) {
+			*address = PacketFormat::BROADCAST_ADDRESS;
+			return true;
+		}
+
+		for(uint8_t i = 0; i < this->_count; ++i) {
+			if(this->_entries[i].id == id) {
+				*address = this->_entries[i].address;
+				return true;
+			}
+		}
+
+		return false;
+
+	}
+
+	/**
+	 * ID of a short address
+	 * @param  {uint8_t} address    :
+	 * @param  {uint16_t*} const    :
+	 * @return {bool}               : false if address is not mapped
+	 */
+	bool toId(const uint8_t address, uint16_t* const id) const noexcept {
+
+		if(address == PacketFormat::BROADCAST_ADDRESS) {
+			*id = PacketFormat::BROADCAST_ID;
+			return true;
+		}
+
+		for(uint8_t i = 0; i < this->_count; ++i) {
+			if(this->_entries[i].address == address) {
+				*id = this->_entries[i].id;
+				return true;
+			}
+		}
+
+		return false;
+
+	}
+
+	uint8_t getCount() const noexcept {
+		return this->_count;
+	}
+
+	void clear() noexcept {
+		this->_count = 0;
+	}
+
+};
+};
+
+#endif
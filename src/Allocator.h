@@ -0,0 +1,204 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef ALLOCATOR_H_DD905B54_99E8_4AA2_A558_54D599D47129
+#define ALLOCATOR_H_DD905B54_99E8_4AA2_A558_54D599D47129
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <new>
+
+/**
+ * Allocators for the library's heap allocations.
+ *
+ * An allocator is a type with three static functions:
+ *
+ * 	void* allocate(size_t bytes)
+ * 	void* reallocate(void* p, size_t bytes, size_t newBytes, size_t keepBytes)
+ * 	void deallocate(void* p, size_t bytes)
+ *
+ * allocate and reallocate return nullptr on failure; a failed reallocate
+ * leaves p untouched. reallocate need only keep the first keepBytes of p.
+ *
+ * Define RADIOPACKET_ALLOCATOR(T) to choose the allocator used for heap
+ * allocations made on behalf of library type T (Message, RadioPacket or
+ * HeapStorage). eg. to account for each type separately:
+ *
+ * 	-D'RADIOPACKET_ALLOCATOR(T)=::RadioPacket::AccountingAllocator<T>'
+ */
+#ifndef RADIOPACKET_ALLOCATOR
+	#define RADIOPACKET_ALLOCATOR(T) NewAllocator
+#endif
+
+namespace RadioPacket {
+
+/**
+ * Allocates with the global, non-throwing operator new
+ */
+struct NewAllocator {
+
+	static void* allocate(const size_t bytes) noexcept {
+		return ::operator new(bytes, std::nothrow);
+	}
+
+	static void* reallocate(
+		void* const p,
+		const size_t bytes,
+		const size_t newBytes,
+		const size_t keepBytes) noexcept {
+
+			void* const q = NewAllocator::allocate(newBytes);
+
+			if(q == nullptr) {
+				return nullptr;
+			}
+
+			::memcpy(q, p, keepBytes);
+			NewAllocator::deallocate(p, bytes);
+
+			return q;
+
+	}
+
+	static void deallocate(void* const p, const size_t) noexcept {
+		::operator delete(p);
+	}
+
+};
+
+/**
+ * Running totals kept by an AccountingAllocator
+ */
+struct AllocationStats {
+	uint32_t allocations = 0;
+	uint32_t deallocations = 0;
+	uint32_t reallocations = 0;
+	uint32_t failures = 0;
+	size_t outstandingBytes = 0;
+	size_t peakBytes = 0;
+};
+
+/**
+ * Passes allocations through to Upstream, keeping a separate set of
+ * AllocationStats for each Tag. Counters are not synchronised; only
+ * allocate from one thread, and not from an ISR.
+ *
+ * eg. to check the receive path is allocation-free after warm-up:
+ *
+ * 	AccountingAllocator<Message>::resetStats();
+ * 	receive();
+ * 	AccountingAllocator<Message>::getStats().allocations == 0;
+ */
+template<class Tag, class Upstream = NewAllocator>
+struct AccountingAllocator {
+
+protected:
+
+	static AllocationStats _stats;
+
+	static void _grow(const size_t bytes) noexcept {
+
+		_stats.outstandingBytes += bytes;
+
+		if(_stats.outstandingBytes > _stats.peakBytes) {
+			_stats.peakBytes = _stats.outstandingBytes;
+		}
+
+	}
+
+public:
+
+	static void* allocate(const size_t bytes) noexcept {
+
+		void* const p = Upstream::allocate(bytes);
+
+		if(p == nullptr) {
+			++_stats.failures;
+			return nullptr;
+		}
+
+		++_stats.allocations;
+		_grow(bytes);
+
+		return p;
+
+	}
+
+	static void* reallocate(
+		void* const p,
+		const size_t bytes,
+		const size_t newBytes,
+		const size_t keepBytes) noexcept {
+
+			void* const q = Upstream::reallocate(p, bytes, newBytes, keepBytes);
+
+			if(q == nullptr) {
+				++_stats.failures;
+				return nullptr;
+			}
+
+			++_stats.reallocations;
+			_stats.outstandingBytes -= bytes;
+			_grow(newBytes);
+
+			return q;
+
+	}
+
+	static void deallocate(void* const p, const size_t bytes) noexcept {
+
+		if(p == nullptr) {
+			return;
+		}
+
+		Upstream::deallocate(p, bytes);
+
+		++_stats.deallocations;
+		_stats.outstandingBytes -= bytes;
+
+	}
+
+	static const AllocationStats& getStats() noexcept {
+		return _stats;
+	}
+
+	/**
+	 * Zero the counters to begin a new measurement; bytes still
+	 * outstanding are kept, and become the new peak
+	 */
+	static void resetStats() noexcept {
+		const size_t outstanding = _stats.outstandingBytes;
+		_stats = AllocationStats();
+		_stats.outstandingBytes = outstanding;
+		_stats.peakBytes = outstanding;
+	}
+
+};
+
+template<class Tag, class Upstream>
+AllocationStats AccountingAllocator<Tag, Upstream>::_stats;
+
+};
+
+#endif
@@ -0,0 +1,163 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef ATOMIC_H_A7B33307_1AB2_4660_8B54_A52AC5B88F67
+#define ATOMIC_H_A7B33307_1AB2_4660_8B54_A52AC5B88F67
+
+#include "Platform.h"
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	#include <util/atomic.h>
+#else
+	#include <atomic>
+#endif
+
+/**
+ * A value shared between contexts: ISRs and the main loop on AVR, or
+ * threads on a host.
+ *
+ * On a host this is std::atomic. AVR has no <atomic>, but is single core,
+ * so each access is made with interrupts disabled; that is also a
+ * compiler barrier, so plain memory written before a store is visible to
+ * whoever loads the stored value.
+ */
+namespace RadioPacket {
+
+template<class T>
+class Atomic {
+
+protected:
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	volatile T _value;
+#else
+	std::atomic<T> _value;
+#endif
+
+
+public:
+
+	Atomic(const T value = T()) noexcept
+		: _value(value) {
+	}
+
+	Atomic(const Atomic& a) = delete;
+	Atomic& operator=(const Atomic& a) = delete;
+
+	/**
+	 * Load with acquire ordering; writes made before the matching store
+	 * are visible afterwards
+	 * @return {T}  :
+	 */
+	T load() const noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		T value;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			value = this->_value;
+		}
+		return value;
+#else
+		return this->_value.load(std::memory_order_acquire);
+#endif
+	}
+
+	/**
+	 * Load with no ordering; only for the context which stores the value
+	 * @return {T}  :
+	 */
+	T loadRelaxed() const noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		return this->load();
+#else
+		return this->_value.load(std::memory_order_relaxed);
+#endif
+	}
+
+	/**
+	 * Store with release ordering
+	 * @param  {T} value :
+	 */
+	void store(const T value) noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			this->_value = value;
+		}
+#else
+		this->_value.store(value, std::memory_order_release);
+#endif
+	}
+
+	/**
+	 * If the value equals expected, replace it with desired and return
+	 * true. Otherwise set expected to the current value and return false.
+	 * May fail spuriously on a host, so call in a loop. Acquire and
+	 * release ordering.
+	 * @param  {T&} expected :
+	 * @param  {T} desired   :
+	 * @return {bool}        :
+	 */
+	bool compareExchangeWeak(T& expected, const T desired) noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		bool exchanged = false;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			if(this->_value == expected) {
+				this->_value = desired;
+				exchanged = true;
+			}
+			else {
+				expected = this->_value;
+			}
+		}
+		return exchanged;
+#else
+		return this->_value.compare_exchange_weak(
+			expected,
+			desired,
+			std::memory_order_acq_rel,
+			std::memory_order_acquire);
+#endif
+	}
+
+	/**
+	 * Add n and return the previous value. No ordering; for counters.
+	 * @param  {T} n :
+	 * @return {T}   :
+	 */
+	T fetchAdd(const T n) noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		T value;
+		ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+			value = this->_value;
+			this->_value = value + n;
+		}
+		return value;
+#else
+		return this->_value.fetch_add(n, std::memory_order_relaxed);
+#endif
+	}
+
+};
+
+};
+
+#endif
@@ -0,0 +1,106 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BufferReader.h"
+
+#include <string.h>
+
+namespace RadioPacket {
+
+BufferReader::BufferReader(const uint8_t* const data, const size_t len) noexcept
+	: _data(data), _length(len) {
+}
+
+bool BufferReader::_available(const size_t bits) noexcept {
+
+	if(this->_overflowed || this->_data == nullptr ||
+		bits > this->getRemainingBits()) {
+			this->_overflowed = true;
+			return false;
+	}
+
+	return true;
+
+}
+
+void BufferReader::reset() noexcept {
+	this->_bitPosition = 0;
+	this->_overflowed = false;
+}
+
+bool BufferReader::readBool() noexcept {
+	return this->readBits<uint8_t>(1) != 0;
+}
+
+uint8_t BufferReader::readUInt8() noexcept {
+	return this->readBits<uint8_t>(8);
+}
+
+uint16_t BufferReader::readUInt16() noexcept {
+	return this->readBits<uint16_t>(16);
+}
+
+uint32_t BufferReader::readUInt32() noexcept {
+	return this->readBits<uint32_t>(32);
+}
+
+uint64_t BufferReader::readUInt64() noexcept {
+	return this->readBits<uint64_t>(64);
+}
+
+void BufferReader::readBytes(uint8_t* const bytes, const size_t len) noexcept {
+
+	this->align();
+
+	if(bytes == nullptr || !this->_available(len * 8)) {
+		return;
+	}
+
+	::memcpy(bytes, this->_data + this->_bitPosition / 8, len);
+	this->_bitPosition += len * 8;
+
+}
+
+void BufferReader::align() noexcept {
+
+	const uint8_t skip = (8 - (this->_bitPosition & 7)) & 7;
+
+	if(this->_available(skip)) {
+		this->_bitPosition += skip;
+	}
+
+}
+
+size_t BufferReader::getBitPosition() const noexcept {
+	return this->_bitPosition;
+}
+
+size_t BufferReader::getRemainingBits() const noexcept {
+	return this->_length * 8 - this->_bitPosition;
+}
+
+bool BufferReader::hasOverflowed() const noexcept {
+	return this->_overflowed;
+}
+
+};
@@ -0,0 +1,169 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef BUFFER_READER_H_557D6DAB_ABFB_45BF_BB0F_7DEA8894BE4C
+#define BUFFER_READER_H_557D6DAB_ABFB_45BF_BB0F_7DEA8894BE4C
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Meta.h"
+#include "Util.h"
+
+namespace RadioPacket {
+
+/**
+ * Reads back, in the same order, fields written by a BufferWriter.
+ *
+ * A read which would run past the end of the data returns 0, as does
+ * every read after it, and hasOverflowed() becomes true. A malformed
+ * varint is treated the same way.
+ */
+class BufferReader {
+
+protected:
+
+	const uint8_t* _data;
+	size_t _length;
+	size_t _bitPosition = 0;
+	bool _overflowed = false;
+
+	/**
+	 * Check bits more bits are there to read
+	 * @param  {size_t} bits : 
+	 * @return {bool}        : 
+	 */
+	bool _available(const size_t bits) noexcept;
+
+
+public:
+
+	/**
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : in bytes
+	 */
+	BufferReader(const uint8_t* const data, const size_t len) noexcept;
+
+	/**
+	 * Start again from the beginning of the data
+	 */
+	void reset() noexcept;
+
+	/**
+	 * Read width bits
+	 * @param  {uint8_t} width : up to the width of T
+	 * @return {T}             : 
+	 */
+	template<class T = uint32_t>
+	T readBits(const uint8_t width) noexcept {
+
+		if(!this->_available(width)) {
+			return 0;
+		}
+
+		const T v = Util::getBits<T>(this->_data, this->_bitPosition, width);
+		this->_bitPosition += width;
+
+		return v;
+
+	}
+
+	bool readBool() noexcept;
+	uint8_t readUInt8() noexcept;
+	uint16_t readUInt16() noexcept;
+	uint32_t readUInt32() noexcept;
+	uint64_t readUInt64() noexcept;
+
+	/**
+	 * Read an LEB128 varint
+	 * @return {T}  : 
+	 */
+	template<class T>
+	T readVarUInt() noexcept {
+
+		uint8_t bytes[(sizeof(T) * 8 + 6) / 7];
+		uint8_t n = 0;
+
+		//gather bytes up to and including the one without the
+		//continuation bit
+		do {
+
+			if(n == sizeof(bytes) || !this->_available(8)) {
+				this->_overflowed = true;
+				return 0;
+			}
+
+			bytes[n] = this->readUInt8();
+
+		} while((bytes[n++] & 0x80) != 0);
+
+		T v = 0;
+
+		if(Util::decodeVarint(bytes, n, &v) == 0) {
+			this->_overflowed = true;
+			return 0;
+		}
+
+		return v;
+
+	}
+
+	/**
+	 * Read a zigzag varint
+	 * @return {T}  : signed integer
+	 */
+	template<class T>
+	T readVarInt() noexcept {
+		return Util::zigzagDecode(
+			this->readVarUInt<typename Meta::MakeUnsigned<T>::Type>());
+	}
+
+	/**
+	 * Skip to the next byte boundary and copy len bytes
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : 
+	 */
+	void readBytes(uint8_t* const bytes, const size_t len) noexcept;
+
+	/**
+	 * Skip to the next byte boundary
+	 */
+	void align() noexcept;
+
+	size_t getBitPosition() const noexcept;
+
+	/**
+	 * Number of bits left to read
+	 * @return {size_t}  : 
+	 */
+	size_t getRemainingBits() const noexcept;
+
+	/**
+	 * Whether any read has run past the end of the data
+	 * @return {bool}  : 
+	 */
+	bool hasOverflowed() const noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,122 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "BufferWriter.h"
+
+#include <string.h>
+
+namespace RadioPacket {
+
+BufferWriter::BufferWriter(uint8_t* const data, const size_t capacity) noexcept
+	: _data(data), _capacity(capacity) {
+}
+
+bool BufferWriter::_reserve(const size_t bits) noexcept {
+
+	if(this->_overflowed || this->_data == nullptr ||
+		bits > this->_capacity * 8 - this->_bitPosition) {
+			this->_overflowed = true;
+			return false;
+	}
+
+	//bytes which have not been written to yet
+	const size_t first = (this->_bitPosition + 7) / 8;
+	const size_t last = (this->_bitPosition + bits + 7) / 8;
+
+	if(last > first) {
+		::memset(this->_data + first, 0, last - first);
+	}
+
+	return true;
+
+}
+
+void BufferWriter::reset() noexcept {
+	this->_bitPosition = 0;
+	this->_overflowed = false;
+}
+
+void BufferWriter::writeBool(const bool b) noexcept {
+	this->writeBits<uint8_t>(b ? 1 : 0, 1);
+}
+
+void BufferWriter::writeUInt8(const uint8_t v) noexcept {
+	this->writeBits(v, 8);
+}
+
+void BufferWriter::writeUInt16(const uint16_t v) noexcept {
+	this->writeBits(v, 16);
+}
+
+void BufferWriter::writeUInt32(const uint32_t v) noexcept {
+	this->writeBits(v, 32);
+}
+
+void BufferWriter::writeUInt64(const uint64_t v) noexcept {
+	this->writeBits(v, 64);
+}
+
+void BufferWriter::writeBytes(const uint8_t* const bytes, const size_t len) noexcept {
+
+	this->align();
+
+	if(bytes == nullptr || !this->_reserve(len * 8)) {
+		return;
+	}
+
+	::memcpy(this->_data + this->_bitPosition / 8, bytes, len);
+	this->_bitPosition += len * 8;
+
+}
+
+void BufferWriter::align() noexcept {
+
+	const uint8_t pad = (8 - (this->_bitPosition & 7)) & 7;
+
+	if(pad > 0) {
+		this->writeBits<uint8_t>(0, pad);
+	}
+
+}
+
+size_t BufferWriter::getLength() const noexcept {
+	return (this->_bitPosition + 7) / 8;
+}
+
+size_t BufferWriter::getBitPosition() const noexcept {
+	return this->_bitPosition;
+}
+
+size_t BufferWriter::getCapacity() const noexcept {
+	return this->_capacity;
+}
+
+const uint8_t* BufferWriter::getData() const noexcept {
+	return this->_data;
+}
+
+bool BufferWriter::hasOverflowed() const noexcept {
+	return this->_overflowed;
+}
+
+};
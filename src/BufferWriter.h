@@ -0,0 +1,158 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef BUFFER_WRITER_H_7398E034_3DD7_42F7_BA85_3B5D3C438120
+#define BUFFER_WRITER_H_7398E034_3DD7_42F7_BA85_3B5D3C438120
+
+#include <stddef.h>
+#include <stdint.h>
+#include "Meta.h"
+#include "Util.h"
+
+namespace RadioPacket {
+
+/**
+ * Streams fields of any bit width, varints and plain bytes into a
+ * caller's buffer, one after another. Bits are written most significant
+ * first and multi-byte integers in network order, so a field may start
+ * anywhere in a byte.
+ *
+ * A write which would run past the end of the buffer is dropped and
+ * every write after it is ignored; check hasOverflowed() once at the end
+ * rather than after each field.
+ */
+class BufferWriter {
+
+protected:
+
+	uint8_t* _data;
+	size_t _capacity;
+	size_t _bitPosition = 0;
+	bool _overflowed = false;
+
+	/**
+	 * Check bits more bits fit and zero any bytes they start, so unused
+	 * trailing bits read as 0
+	 * @param  {size_t} bits : 
+	 * @return {bool}        : 
+	 */
+	bool _reserve(const size_t bits) noexcept;
+
+
+public:
+
+	/**
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} capacity : in bytes
+	 */
+	BufferWriter(uint8_t* const data, const size_t capacity) noexcept;
+
+	/**
+	 * Start again from the beginning of the buffer
+	 */
+	void reset() noexcept;
+
+	/**
+	 * Write the low width bits of v
+	 * @param  {T} v           : 
+	 * @param  {uint8_t} width : up to the width of T
+	 */
+	template<class T>
+	void writeBits(const T v, const uint8_t width) noexcept {
+
+		if(!this->_reserve(width)) {
+			return;
+		}
+
+		Util::setBits(this->_data, this->_bitPosition, width, v);
+		this->_bitPosition += width;
+
+	}
+
+	void writeBool(const bool b) noexcept;
+	void writeUInt8(const uint8_t v) noexcept;
+	void writeUInt16(const uint16_t v) noexcept;
+	void writeUInt32(const uint32_t v) noexcept;
+	void writeUInt64(const uint64_t v) noexcept;
+
+	/**
+	 * Write an unsigned integer as an LEB128 varint
+	 * @param  {T} v : 
+	 */
+	template<class T>
+	void writeVarUInt(const T v) noexcept {
+
+		uint8_t bytes[(sizeof(T) * 8 + 6) / 7];
+		const uint8_t n = Util::encodeVarint(bytes, sizeof(bytes), v);
+
+		if(!this->_reserve(static_cast<size_t>(n) * 8)) {
+			return;
+		}
+
+		for(uint8_t i = 0; i < n; ++i) {
+			this->writeUInt8(bytes[i]);
+		}
+
+	}
+
+	/**
+	 * Write a signed integer as a zigzag varint
+	 * @param  {T} v : 
+	 */
+	template<class T>
+	void writeVarInt(const T v) noexcept {
+		this->writeVarUInt(Util::zigzagEncode(v));
+	}
+
+	/**
+	 * Pad to the next byte boundary and copy len bytes
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : 
+	 */
+	void writeBytes(const uint8_t* const bytes, const size_t len) noexcept;
+
+	/**
+	 * Pad with 0 bits to the next byte boundary
+	 */
+	void align() noexcept;
+
+	/**
+	 * Number of bytes written to, including a partly written last byte
+	 * @return {size_t}  : 
+	 */
+	size_t getLength() const noexcept;
+
+	size_t getBitPosition() const noexcept;
+	size_t getCapacity() const noexcept;
+	const uint8_t* getData() const noexcept;
+
+	/**
+	 * Whether any write has been dropped for want of space
+	 * @return {bool}  : 
+	 */
+	bool hasOverflowed() const noexcept;
+
+};
+};
+
+#endif
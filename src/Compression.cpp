@@ -0,0 +1,262 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Compression.h"
+
+#include <string.h>
+#include "Util.h"
+
+namespace RadioPacket {
+
+Compression::Compression() {
+}
+
+size_t Compression::compress(
+	const uint8_t codec,
+	const uint8_t* const in,
+	const size_t len,
+	uint8_t* const out,
+	const size_t capacity,
+	const CompressionDictionary* const dict) noexcept {
+
+		//the result must be shorter than len, and len must fit the header
+		const size_t limit = len - 1 < capacity ? len - 1 : capacity;
+
+		if(len <= Compression::getHeaderLength() || len > 0xffff ||
+			limit <= Compression::getHeaderLength()) {
+				return 0;
+		}
+
+		uint8_t* const data = out + Compression::getHeaderLength();
+		const size_t dataCapacity = limit - Compression::getHeaderLength();
+		size_t n = 0;
+
+		switch(codec) {
+			case Compression::CODEC_RUN_LENGTH:
+				n = RunLengthEncoder::encode(in, len, data, dataCapacity);
+				break;
+			case Compression::CODEC_LZ:
+				n = LzEncoder::encode(in, len, data, dataCapacity, dict);
+				break;
+			default:
+				return 0;
+		}
+
+		if(n == 0) {
+			return 0;
+		}
+
+		const uint16_t netLen = (Util::htons)(static_cast<uint16_t>(len));
+
+		out[Compression::_CODEC_OFFSET] = codec;
+		::memcpy(&out[Compression::_LENGTH_OFFSET], &netLen, sizeof(uint16_t));
+
+		return Compression::getHeaderLength() + n;
+
+}
+
+bool Compression::compress(
+	const Message* const in,
+	Message* const out,
+	const uint8_t codec,
+	const CompressionDictionary* const dict) noexcept {
+
+		const uint16_t len = in->getRawBodyLength();
+
+		if(out == in || Compression::isCompressed(in->getRawAction()) || len < 2) {
+			if(out != in) {
+				*out = *in;
+			}
+			return false;
+		}
+
+		//compress into out's body, then shrink it to fit
+		out->resizeBody(len - 1, false);
+
+		const size_t n = out->getMessageLength() == Message::getHeaderLength() + len - 1
+			? Compression::compress(
+				codec,
+				in->getBodyData(),
+				len,
+				&out->_data[Message::_BODY_OFFSET],
+				len - 1,
+				dict)
+			: 0;
+
+		if(n == 0) {
+			*out = *in;
+			return false;
+		}
+
+		out->resizeBody(static_cast<uint16_t>(n), true);
+		out->setRawAction(in->getRawAction() | Compression::ACTION_FLAG);
+
+		return true;
+
+}
+
+uint8_t Compression::decompress(
+	const MessageView& in,
+	Message* const out,
+	const CompressionDictionary* const dict) noexcept {
+
+		if(!Compression::isCompressed(in.getRawAction())) {
+			return Compression::DECOMPRESS_ERROR_NOT_COMPRESSED;
+		}
+
+		const uint8_t* const body = in.getBodyData();
+		const uint16_t bodyLen = in.getRawBodyLength();
+
+		if(bodyLen < Compression::getHeaderLength()) {
+			return Compression::DECOMPRESS_ERROR_CORRUPT;
+		}
+
+		uint16_t netLen;
+		::memcpy(&netLen, &body[Compression::_LENGTH_OFFSET], sizeof(uint16_t));
+		const uint16_t len = (Util::ntohs)(netLen);
+
+		if(len > Message::getMaxBodyLength()) {
+			return Compression::DECOMPRESS_ERROR_CORRUPT;
+		}
+
+		out->reset();
+		out->resizeBody(len, false);
+
+		if(out->getMessageLength() != Message::getHeaderLength() + len) {
+			return Compression::DECOMPRESS_ERROR_OUT_OF_MEMORY;
+		}
+
+		Decompressor d(dict);
+		size_t consumed;
+		const size_t n = d.decode(body, bodyLen, &consumed, &out->_data[Message::_BODY_OFFSET], len);
+
+		if(d.getStatus() != Compression::DECOMPRESS_OK) {
+			return d.getStatus();
+		}
+
+		if(n != len || !d.isComplete()) {
+			return Compression::DECOMPRESS_ERROR_CORRUPT;
+		}
+
+		out->setRawAction(Compression::getAction(in.getRawAction()));
+
+		return Compression::DECOMPRESS_OK;
+
+}
+
+Decompressor::Decompressor(const CompressionDictionary* const dict) noexcept
+	: _dict(dict) {
+		this->reset();
+}
+
+void Decompressor::reset() noexcept {
+	this->_headerLen = 0;
+	this->_length = 0;
+	this->_remaining = 0;
+	this->_status = Compression::DECOMPRESS_OK;
+}
+
+size_t Decompressor::decode(
+	const uint8_t* const in,
+	const size_t len,
+	size_t* const consumed,
+	uint8_t* const out,
+	const size_t capacity) noexcept {
+
+		size_t i = 0;
+		size_t o = 0;
+
+		*consumed = 0;
+
+		if(this->_status != Compression::DECOMPRESS_OK) {
+			return 0;
+		}
+
+		//the header may arrive a byte at a time
+		while(this->_headerLen < Compression::getHeaderLength() && i < len) {
+
+			this->_header[this->_headerLen++] = in[i++];
+
+			if(this->_headerLen < Compression::getHeaderLength()) {
+				continue;
+			}
+
+			uint16_t netLen;
+			::memcpy(&netLen, &this->_header[Compression::_LENGTH_OFFSET], sizeof(uint16_t));
+			this->_length = (Util::ntohs)(netLen);
+			this->_remaining = this->_length;
+
+			switch(this->_header[Compression::_CODEC_OFFSET]) {
+				case Compression::CODEC_RUN_LENGTH:
+					this->_runLength.reset();
+					break;
+				case Compression::CODEC_LZ:
+					this->_lz.reset(this->_dict);
+					break;
+				default:
+					this->_status = Compression::DECOMPRESS_ERROR_UNKNOWN_CODEC;
+					*consumed = i;
+					return 0;
+			}
+
+		}
+
+		if(this->_headerLen == Compression::getHeaderLength() && this->_remaining > 0) {
+
+			const size_t space = capacity < this->_remaining ? capacity : this->_remaining;
+			size_t used = 0;
+
+			if(this->_header[Compression::_CODEC_OFFSET] == Compression::CODEC_LZ) {
+				o = this->_lz.decode(in + i, len - i, &used, out, space);
+				if(this->_lz.isError()) {
+					this->_status = Compression::DECOMPRESS_ERROR_CORRUPT;
+				}
+			}
+			else {
+				o = this->_runLength.decode(in + i, len - i, &used, out, space);
+			}
+
+			i += used;
+			this->_remaining -= static_cast<uint16_t>(o);
+
+		}
+
+		*consumed = i;
+
+		return o;
+
+}
+
+bool Decompressor::isComplete() const noexcept {
+	return this->_headerLen == Compression::getHeaderLength() && this->_remaining == 0;
+}
+
+uint16_t Decompressor::getLength() const noexcept {
+	return this->_length;
+}
+
+uint8_t Decompressor::getStatus() const noexcept {
+	return this->_status;
+}
+
+};
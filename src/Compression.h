@@ -0,0 +1,247 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef COMPRESSION_H_5E7D7955_3D4C_463D_A7CB_23CEFB0795C1
+#define COMPRESSION_H_5E7D7955_3D4C_463D_A7CB_23CEFB0795C1
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "LzCodec.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "RunLengthCodec.h"
+
+/**
+ * Optional compression of Message bodies, to spend MCU time rather than
+ * airtime.
+ *
+ * A compressed Message has the top bit of its action set (ACTION_FLAG)
+ * and a body formatted as such:
+ *
+ * 	HEADER	| 0x0 - 0x0				[ CODEC, 1 byte, unsigned ]
+ * 			| 0x1 - 0x2				[ ORIGINAL BODY LENGTH, 2 bytes, unsigned ]
+ * 	DATA	| 0x3 - {BODY LEN - 1}	[ CODED BODY ]
+ *
+ * Actions 0x8000 and above are therefore reserved. A body is only sent
+ * compressed if that makes it shorter, so receivers must handle both.
+ *
+ * 	CODEC_RUN_LENGTH	| PackBits; see RunLengthCodec.h
+ * 	CODEC_LZ			| LZSS with an optional pre-shared dictionary;
+ * 						| see LzCodec.h
+ *
+ * Transmitters can compress straight into a packet with
+ * PacketEncoder::encodeMessage, or compress a Message to be fragmented.
+ * Receivers decompress a whole Message, or a body in chunks with a
+ * Decompressor.
+ */
+namespace RadioPacket {
+
+class Compression {
+
+protected:
+
+	static const uint8_t _CODEC_OFFSET = 0x0;
+	static const uint8_t _LENGTH_OFFSET = 0x1;
+	static const uint8_t _HEADER_LEN = 3;
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	Compression();
+
+	friend class Decompressor;
+
+
+public:
+
+	static const uint16_t ACTION_FLAG = 0x8000;
+
+	static const uint8_t CODEC_RUN_LENGTH = 1;
+	static const uint8_t CODEC_LZ = 2;
+
+	static const uint8_t DECOMPRESS_OK = 0;
+	static const uint8_t DECOMPRESS_ERROR_NOT_COMPRESSED = 1;
+	static const uint8_t DECOMPRESS_ERROR_UNKNOWN_CODEC = 2;
+	static const uint8_t DECOMPRESS_ERROR_CORRUPT = 3;
+	static const uint8_t DECOMPRESS_ERROR_OUT_OF_MEMORY = 4;
+
+	static constexpr uint8_t getHeaderLength() noexcept {
+		return _HEADER_LEN;
+	}
+
+	/**
+	 * Whether a Message with the given action has a compressed body
+	 * @param  {uint16_t} action :
+	 * @return {bool}            :
+	 */
+	static constexpr bool isCompressed(const uint16_t action) noexcept {
+		return (action & ACTION_FLAG) != 0;
+	}
+
+	/**
+	 * The action without ACTION_FLAG
+	 * @param  {uint16_t} action :
+	 * @return {uint16_t}        :
+	 */
+	static constexpr uint16_t getAction(const uint16_t action) noexcept {
+		return action & static_cast<uint16_t>(~ACTION_FLAG);
+	}
+
+	/**
+	 * Compress len bytes of in with codec into out, header included, and
+	 * return the compressed length. Returns 0 if codec is unknown, or if
+	 * the result would be no shorter than len or would exceed capacity.
+	 * @param  {uint8_t} codec               : one of the CODEC_* constants
+	 * @param  {uint8_t*} const              : 
+	 * @param  {size_t} len                  : 
+	 * @param  {uint8_t*} const              : 
+	 * @param  {size_t} capacity             : 
+	 * @param  {CompressionDictionary*} dict : for CODEC_LZ; nullptr for none
+	 * @return {size_t}                      : compressed length
+	 */
+	static size_t compress(
+		const uint8_t codec,
+		const uint8_t* const in,
+		const size_t len,
+		uint8_t* const out,
+		const size_t capacity,
+		const CompressionDictionary* const dict = nullptr) noexcept;
+
+	/**
+	 * Set out to a copy of in, compressed with codec if that makes it
+	 * shorter. Returns true if out was compressed.
+	 * @param  {Message*} in                 : 
+	 * @param  {Message*} out                : 
+	 * @param  {uint8_t} codec               : one of the CODEC_* constants
+	 * @param  {CompressionDictionary*} dict : for CODEC_LZ; nullptr for none
+	 * @return {bool}                        : 
+	 */
+	static bool compress(
+		const Message* const in,
+		Message* const out,
+		const uint8_t codec,
+		const CompressionDictionary* const dict = nullptr) noexcept;
+
+	/**
+	 * Set out to the decompressed copy of in, with ACTION_FLAG cleared from
+	 * its action. The whole body is decompressed at once; use a
+	 * Decompressor to do it in chunks.
+	 * @param  {MessageView} in              : 
+	 * @param  {Message*} out                : 
+	 * @param  {CompressionDictionary*} dict : as given to compress
+	 * @return {uint8_t}                     : one of the DECOMPRESS_* constants
+	 */
+	static uint8_t decompress(
+		const MessageView& in,
+		Message* const out,
+		const CompressionDictionary* const dict = nullptr) noexcept;
+
+};
+
+/**
+ * Decompresses a compressed Message body (header included) fed in chunks
+ * of any size, writing the original body out in chunks of any size. This
+ * suits a gateway passing bodies on as they arrive, or one which does not
+ * want to hold a whole decompressed body at once.
+ *
+ * The LZ decoder's window makes a Decompressor a little over 4KB.
+ *
+ * 	Decompressor d(&dictionary);
+ *
+ * 	while(!d.isComplete() && d.getStatus() == Compression::DECOMPRESS_OK) {
+ * 		n = d.decode(in, inLen, &consumed, out, sizeof(out));
+ * 		in += consumed;
+ * 		inLen -= consumed;
+ * 		//use n bytes of out
+ * 	}
+ */
+class Decompressor {
+
+protected:
+
+	const CompressionDictionary* _dict = nullptr;
+
+	LzDecoder _lz;
+	RunLengthDecoder _runLength;
+
+	uint8_t _header[Compression::_HEADER_LEN];
+	uint8_t _headerLen = 0;
+	uint16_t _length = 0;
+	uint16_t _remaining = 0;
+	uint8_t _status = Compression::DECOMPRESS_OK;
+
+
+public:
+
+	/**
+	 * @param  {CompressionDictionary*} dict : as given to compress
+	 */
+	Decompressor(const CompressionDictionary* const dict = nullptr) noexcept;
+
+	/**
+	 * Start a new body
+	 */
+	void reset() noexcept;
+
+	/**
+	 * Decode from in into out until in is used up, out is full or the body
+	 * is complete. Returns the number of bytes written to out and sets
+	 * consumed to the number of bytes of in used.
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} len       : 
+	 * @param  {size_t*} consumed : 
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} capacity  : 
+	 * @return {size_t}           : bytes written to out
+	 */
+	size_t decode(
+		const uint8_t* const in,
+		const size_t len,
+		size_t* const consumed,
+		uint8_t* const out,
+		const size_t capacity) noexcept;
+
+	/**
+	 * Whether the whole original body has been written out
+	 * @return {bool}  :
+	 */
+	bool isComplete() const noexcept;
+
+	/**
+	 * Length of the original body; 0 until the header has been decoded
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getLength() const noexcept;
+
+	/**
+	 * DECOMPRESS_OK, or the DECOMPRESS_ERROR_* constant which stopped
+	 * decoding
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getStatus() const noexcept;
+
+};
+};
+
+#endif
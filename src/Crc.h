@@ -0,0 +1,672 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef CRC_H_3576E534_7286_475B_AA81_633DF50A1ABF
+#define CRC_H_3576E534_7286_475B_AA81_633DF50A1ABF
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Meta.h"
+#include "Platform.h"
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	#include <util/crc16.h>
+#elif defined(RADIOPACKET_CRC_CLMUL)
+	#include <emmintrin.h>
+	#include <wmmintrin.h>
+#endif
+
+/**
+ * Table-driven CRC engine, parameterised on width, polynomial, initial
+ * value, reflection and final XOR (the Rocksoft model, with RefIn ==
+ * RefOut).
+ *
+ * Backends are selected at compile time:
+ *
+ * 	AVR		| avr-libc's optimised update functions where the parameters
+ * 			| match one, otherwise bitwise. No tables are used, so no RAM
+ * 			| is spent on them.
+ * 	Host	| slicing-by-8 over tables generated at compile time
+ * 	x86-64	| non-reflected CRCs of 32 or more bytes are folded with
+ * 			| carry-less multiplication when the CPU supports PCLMULQDQ
+ *
+ * All backends produce identical results.
+ */
+namespace RadioPacket {
+
+template<uint8_t Width>
+struct CrcRegister {
+	typedef typename Meta::Conditional<(Width <= 8), uint8_t,
+		typename Meta::Conditional<(Width <= 16), uint16_t, uint32_t>::Type>::Type Type;
+};
+
+/**
+ * Compile-time arithmetic for a CRC; kept separate from Crc so that its
+ * functions are complete before CrcTables uses them in constant expressions
+ */
+template<uint8_t Width, uint32_t Poly, bool Reflect>
+struct CrcMath {
+
+	typedef typename CrcRegister<Width>::Type ValueType;
+
+	static constexpr ValueType mask() noexcept {
+		return static_cast<ValueType>((((1ULL << (Width - 1)) - 1) << 1) | 1);
+	}
+
+	static constexpr uint32_t reflect(const uint32_t v, const uint8_t bits) noexcept {
+		return bits == 0
+			? 0
+			: ((v & 1) << (bits - 1)) | reflect(v >> 1, bits - 1);
+	}
+
+	/**
+	 * Polynomial as used by the register (ie. reflected if Reflect)
+	 */
+	static constexpr ValueType poly() noexcept {
+		return static_cast<ValueType>(Reflect
+			? reflect(Poly & mask(), Width)
+			: Poly & mask());
+	}
+
+	/**
+	 * Shift one bit through the register
+	 */
+	static constexpr ValueType bit(const ValueType c) noexcept {
+		return Reflect
+			? static_cast<ValueType>((c & 1) ? (c >> 1) ^ poly() : c >> 1)
+			: static_cast<ValueType>(((c >> (Width - 1)) & 1)
+				? ((c << 1) ^ poly()) & mask()
+				: (c << 1) & mask());
+	}
+
+	static constexpr ValueType bits(const ValueType c, const uint8_t n) noexcept {
+		return n == 0 ? c : bits(bit(c), n - 1);
+	}
+
+	/**
+	 * Register after shifting byte i into an empty register
+	 */
+	static constexpr ValueType byte(const size_t i) noexcept {
+		return Reflect
+			? bits(static_cast<ValueType>(i), 8)
+			: bits(static_cast<ValueType>(static_cast<uint32_t>(i) << (Width - 8)), 8);
+	}
+
+	/**
+	 * Register after shifting a zero byte through c
+	 */
+	static constexpr ValueType slice(const ValueType c) noexcept {
+		return Reflect
+			? static_cast<ValueType>((static_cast<uint32_t>(c) >> 8) ^ byte(c & 0xff))
+			: static_cast<ValueType>(((static_cast<uint32_t>(c) << 8) & mask()) ^ byte((c >> (Width - 8)) & 0xff));
+	}
+
+	/**
+	 * Slicing table k, entry i: byte i followed by k zero bytes
+	 */
+	static constexpr ValueType entry(const size_t k, const size_t i) noexcept {
+		return k == 0 ? byte(i) : slice(entry(k - 1, i));
+	}
+
+	/**
+	 * 1 in register representation
+	 */
+	static constexpr ValueType one() noexcept {
+		return static_cast<ValueType>(Reflect ? static_cast<uint32_t>(1) << (Width - 1) : 1);
+	}
+
+	/**
+	 * a * b mod poly, in register representation; a's coefficients are
+	 * walked from highest degree to lowest, starting at the ith
+	 */
+	static constexpr ValueType multiply(
+		const ValueType a,
+		const ValueType b,
+		const uint8_t i = 0,
+		const ValueType r = 0) noexcept {
+			return i == Width
+				? r
+				: multiply(a, b, i + 1, static_cast<ValueType>(bit(r) ^
+					(((a >> (Reflect ? i : Width - 1 - i)) & 1) ? b : 0)));
+	}
+
+	static constexpr ValueType square(const ValueType a) noexcept {
+		return multiply(a, a);
+	}
+
+	/**
+	 * x^(8 * 2^k) mod poly; multiplying a register by this shifts 2^k zero
+	 * bytes through it
+	 */
+	static constexpr ValueType zeros(const size_t k) noexcept {
+		return k == 0 ? bits(one(), 8) : square(zeros(k - 1));
+	}
+
+	/**
+	 * Polynomial scaled up to 32 bits (x^32 implied), so that every width
+	 * can share the 32-bit carry-less multiplication backend
+	 */
+	static constexpr uint32_t poly32() noexcept {
+		return static_cast<uint32_t>(Poly & mask()) << (32 - Width);
+	}
+
+	/**
+	 * v * x mod poly32()
+	 */
+	static constexpr uint32_t mulx32(const uint32_t v) noexcept {
+		return (v & 0x80000000UL) ? (v << 1) ^ poly32() : v << 1;
+	}
+
+	/**
+	 * x^n mod poly32()
+	 */
+	static constexpr uint32_t xpow32(const unsigned n) noexcept {
+		return n < 32
+			? static_cast<uint32_t>(1) << n
+			: mulx32(xpow32(n - 1));
+	}
+
+	/**
+	 * Low 32 bits of floor(x^64 / poly32()) for Barrett reduction, from
+	 * bit j onwards
+	 */
+	static constexpr uint32_t mu32(const unsigned j = 0) noexcept {
+		return j == 32
+			? 0
+			: (((xpow32(63 - j) >> 31) & 1) << j) | mu32(j + 1);
+	}
+
+};
+
+template<uint8_t Width, uint32_t Poly, bool Reflect>
+struct CrcTables {
+
+	typedef CrcMath<Width, Poly, Reflect> Math;
+	typedef typename Math::ValueType ValueType;
+
+	struct Table {
+		ValueType v[256];
+	};
+
+	struct Tables {
+		Table t[8];
+	};
+
+	template<size_t... I>
+	static constexpr Table table(const size_t k, Meta::IndexSequence<I...>) noexcept {
+		return Table{{ Math::entry(k, I)... }};
+	}
+
+	template<size_t... K>
+	static constexpr Tables tables(Meta::IndexSequence<K...>) noexcept {
+		return Tables{{ table(K, typename Meta::MakeIndexSequence<256>::Type())... }};
+	}
+
+	static constexpr Tables TABLES = tables(typename Meta::MakeIndexSequence<8>::Type());
+
+	/**
+	 * Entry k is x^(8 * 2^k) mod poly, for each bit of a length
+	 */
+	struct Zeros {
+		ValueType v[sizeof(size_t) * 8];
+	};
+
+	template<size_t... K>
+	static constexpr Zeros zeros(Meta::IndexSequence<K...>) noexcept {
+		return Zeros{{ Math::zeros(K)... }};
+	}
+
+	static constexpr Zeros ZEROS = zeros(typename Meta::MakeIndexSequence<sizeof(size_t) * 8>::Type());
+
+};
+
+template<uint8_t Width, uint32_t Poly, bool Reflect>
+constexpr typename CrcTables<Width, Poly, Reflect>::Tables CrcTables<Width, Poly, Reflect>::TABLES;
+
+template<uint8_t Width, uint32_t Poly, bool Reflect>
+constexpr typename CrcTables<Width, Poly, Reflect>::Zeros CrcTables<Width, Poly, Reflect>::ZEROS;
+
+/**
+ * avr-libc update functions, selected by specialisation when the
+ * parameters match
+ */
+template<uint8_t Width, uint32_t Poly, bool Reflect>
+struct CrcAvrLibc {
+
+	static const bool AVAILABLE = false;
+
+	template<class ValueType>
+	static inline ValueType update(const ValueType crc, const uint8_t) noexcept {
+		return crc;
+	}
+
+};
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+template<>
+struct CrcAvrLibc<8, 0x07, false> {
+	static const bool AVAILABLE = true;
+	static inline uint8_t update(const uint8_t crc, const uint8_t b) noexcept {
+		return ::_crc8_ccitt_update(crc, b);
+	}
+};
+
+template<>
+struct CrcAvrLibc<8, 0x31, true> {
+	static const bool AVAILABLE = true;
+	static inline uint8_t update(const uint8_t crc, const uint8_t b) noexcept {
+		return ::_crc_ibutton_update(crc, b);
+	}
+};
+
+template<>
+struct CrcAvrLibc<16, 0x1021, true> {
+	static const bool AVAILABLE = true;
+	static inline uint16_t update(const uint16_t crc, const uint8_t b) noexcept {
+		return ::_crc_ccitt_update(crc, b);
+	}
+};
+
+template<>
+struct CrcAvrLibc<16, 0x1021, false> {
+	static const bool AVAILABLE = true;
+	static inline uint16_t update(const uint16_t crc, const uint8_t b) noexcept {
+		return ::_crc_xmodem_update(crc, b);
+	}
+};
+
+template<>
+struct CrcAvrLibc<16, 0x8005, true> {
+	static const bool AVAILABLE = true;
+	static inline uint16_t update(const uint16_t crc, const uint8_t b) noexcept {
+		return ::_crc16_update(crc, b);
+	}
+};
+#endif
+
+template<uint8_t Width, uint32_t Poly, uint32_t Init, bool Reflect, uint32_t XorOut>
+class Crc {
+
+	static_assert(Width == 8 || Width == 16 || Width == 24 || Width == 32,
+		"CRC width must be a whole number of bytes, up to 32 bits");
+
+public:
+
+	typedef typename CrcRegister<Width>::Type ValueType;
+
+
+protected:
+
+	typedef CrcMath<Width, Poly, Reflect> _Math;
+	typedef CrcTables<Width, Poly, Reflect> _Tables;
+
+	static inline uint32_t _readBigEndian(const uint8_t* const p) noexcept {
+		return (static_cast<uint32_t>(p[0]) << 24) |
+			(static_cast<uint32_t>(p[1]) << 16) |
+			(static_cast<uint32_t>(p[2]) << 8) |
+			static_cast<uint32_t>(p[3]);
+	}
+
+	static inline uint32_t _readLittleEndian(const uint8_t* const p) noexcept {
+		return (static_cast<uint32_t>(p[3]) << 24) |
+			(static_cast<uint32_t>(p[2]) << 16) |
+			(static_cast<uint32_t>(p[1]) << 8) |
+			static_cast<uint32_t>(p[0]);
+	}
+
+	static ValueType _updateSliced(ValueType crc, const uint8_t* p, size_t len) noexcept {
+
+		const typename _Tables::Table* const t = _Tables::TABLES.t;
+
+		while(len >= 8) {
+
+			uint32_t a;
+			uint32_t b;
+
+			if(Reflect) {
+				a = _readLittleEndian(p) ^ crc;
+				b = _readLittleEndian(p + 4);
+				crc = t[7].v[a & 0xff] ^ t[6].v[(a >> 8) & 0xff] ^
+					t[5].v[(a >> 16) & 0xff] ^ t[4].v[a >> 24] ^
+					t[3].v[b & 0xff] ^ t[2].v[(b >> 8) & 0xff] ^
+					t[1].v[(b >> 16) & 0xff] ^ t[0].v[b >> 24];
+			}
+			else {
+				a = _readBigEndian(p) ^ (static_cast<uint32_t>(crc) << (32 - Width));
+				b = _readBigEndian(p + 4);
+				crc = t[7].v[a >> 24] ^ t[6].v[(a >> 16) & 0xff] ^
+					t[5].v[(a >> 8) & 0xff] ^ t[4].v[a & 0xff] ^
+					t[3].v[b >> 24] ^ t[2].v[(b >> 16) & 0xff] ^
+					t[1].v[(b >> 8) & 0xff] ^ t[0].v[b & 0xff];
+			}
+
+			p += 8;
+			len -= 8;
+
+		}
+
+		while(len-- > 0) {
+			crc = Reflect
+				? static_cast<ValueType>((static_cast<uint32_t>(crc) >> 8) ^ t[0].v[(crc ^ *p++) & 0xff])
+				: static_cast<ValueType>(((static_cast<uint32_t>(crc) << 8) & _Math::mask()) ^
+					t[0].v[((crc >> (Width - 8)) ^ *p++) & 0xff]);
+		}
+
+		return crc;
+
+	}
+
+	/**
+	 * a * b mod poly, with both operands in register representation
+	 */
+	static ValueType _multiply(const ValueType a, const ValueType b) noexcept {
+
+		ValueType r = 0;
+
+		//walk a's coefficients from highest degree to lowest; bit() is
+		//multiplication by x in either representation
+		for(uint8_t i = 0; i < Width; ++i) {
+			const ValueType coefficient = static_cast<ValueType>(
+				(a >> (Reflect ? i : Width - 1 - i)) & 1);
+			r = _Math::bit(r) ^ (b & static_cast<ValueType>(0 - coefficient));
+		}
+
+		return r;
+
+	}
+
+#if defined(RADIOPACKET_CRC_CLMUL)
+	__attribute__((target("pclmul")))
+	static inline void _clmul(const uint64_t a, const uint64_t b, uint64_t* const hi, uint64_t* const lo) noexcept {
+		const __m128i r = _mm_clmulepi64_si128(
+			_mm_cvtsi64_si128(static_cast<long long>(a)),
+			_mm_cvtsi64_si128(static_cast<long long>(b)),
+			0x00);
+		*lo = static_cast<uint64_t>(_mm_cvtsi128_si64(r));
+		*hi = static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(r, r)));
+	}
+
+	static inline uint64_t _readBigEndian64(const uint8_t* const p) noexcept {
+		return (static_cast<uint64_t>(_readBigEndian(p)) << 32) | _readBigEndian(p + 4);
+	}
+
+	/**
+	 * Fold 16 byte blocks of a non-reflected CRC with carry-less
+	 * multiplication, then Barrett-reduce back to the register. len must be
+	 * a multiple of 16 and at least 16.
+	 */
+	__attribute__((target("pclmul")))
+	static ValueType _updateClmul(const ValueType crc, const uint8_t* p, size_t len) noexcept {
+
+		const uint64_t k1 = _Math::xpow32(192);
+		const uint64_t k2 = _Math::xpow32(128);
+		const uint64_t k3 = _Math::xpow32(96);
+		const uint64_t k4 = _Math::xpow32(64);
+		const uint64_t mu = _Math::mu32();
+		const uint64_t poly = _Math::poly32();
+
+		uint64_t hi;
+		uint64_t lo;
+		uint64_t h = _readBigEndian64(p) ^ (static_cast<uint64_t>(crc) << (64 - Width));
+		uint64_t l = _readBigEndian64(p + 8);
+
+		for(p += 16, len -= 16; len > 0; p += 16, len -= 16) {
+
+			uint64_t hHi;
+			uint64_t hLo;
+			uint64_t lHi;
+			uint64_t lLo;
+
+			//V * x^128 == H * (x^192 mod P) + L * (x^128 mod P)
+			_clmul(h, k1, &hHi, &hLo);
+			_clmul(l, k2, &lHi, &lLo);
+
+			h = hHi ^ lHi ^ _readBigEndian64(p);
+			l = hLo ^ lLo ^ _readBigEndian64(p + 8);
+
+		}
+
+		//V * x^32 == H * (x^96 mod P) + L * x^32, which fits in 96 bits
+		_clmul(h, k3, &hi, &lo);
+		hi ^= l >> 32;
+		lo ^= l << 32;
+
+		//fold the top 32 bits down to leave 64
+		uint64_t u;
+		uint64_t unused;
+		_clmul(hi, k4, &unused, &u);
+		u ^= lo;
+
+		//Barrett reduction of the remaining 64 bits
+		const uint64_t uh = u >> 32;
+		uint64_t q;
+		_clmul(uh, mu, &hi, &lo);
+		q = uh ^ (lo >> 32);
+		_clmul(q, poly, &hi, &lo);
+
+		const uint32_t r = static_cast<uint32_t>(u) ^ static_cast<uint32_t>(lo);
+
+		return static_cast<ValueType>(r >> (32 - Width));
+
+	}
+
+	static bool _hasClmul() noexcept {
+		static const bool has = __builtin_cpu_supports("pclmul");
+		return has;
+	}
+#endif
+
+
+public:
+
+	/**
+	 * Initial register value
+	 * @return {ValueType}  :
+	 */
+	static constexpr ValueType init() noexcept {
+		return static_cast<ValueType>(Reflect
+			? _Math::reflect(Init & _Math::mask(), Width)
+			: Init & _Math::mask());
+	}
+
+	/**
+	 * Final register value to CRC
+	 * @param  {ValueType} crc :
+	 * @return {ValueType}     :
+	 */
+	static constexpr ValueType finalize(const ValueType crc) noexcept {
+		return static_cast<ValueType>((crc ^ XorOut) & _Math::mask());
+	}
+
+	/**
+	 * Shift len bytes of data through the register, one bit at a time.
+	 * Needs no tables.
+	 * @param  {ValueType} crc  : register
+	 * @param  {uint8_t*} const :
+	 * @param  {size_t} len     :
+	 * @return {ValueType}      : register
+	 */
+	static ValueType updateBitwise(ValueType crc, const uint8_t* const data, const size_t len) noexcept {
+
+		for(size_t i = 0; i < len; ++i) {
+			crc ^= Reflect
+				? static_cast<ValueType>(data[i])
+				: static_cast<ValueType>(static_cast<uint32_t>(data[i]) << (Width - 8));
+			crc = _Math::bits(crc, 8);
+		}
+
+		return crc;
+
+	}
+
+	/**
+	 * Shift len bytes of data through the register using the fastest
+	 * backend available
+	 * @param  {ValueType} crc  : register
+	 * @param  {uint8_t*} const :
+	 * @param  {size_t} len     :
+	 * @return {ValueType}      : register
+	 */
+	static ValueType update(ValueType crc, const uint8_t* const data, const size_t len) noexcept {
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		if(CrcAvrLibc<Width, Poly, Reflect>::AVAILABLE) {
+			for(size_t i = 0; i < len; ++i) {
+				crc = CrcAvrLibc<Width, Poly, Reflect>::update(crc, data[i]);
+			}
+			return crc;
+		}
+		return updateBitwise(crc, data, len);
+#else
+	#if defined(RADIOPACKET_CRC_CLMUL)
+		if(!Reflect && len >= 32 && _hasClmul()) {
+			const size_t folded = len & ~static_cast<size_t>(0xf);
+			crc = _updateClmul(crc, data, folded);
+			return _updateSliced(crc, data + folded, len - folded);
+		}
+	#endif
+		return _updateSliced(crc, data, len);
+#endif
+
+	}
+
+	/**
+	 * Copy len bytes from src to dst, shifting them through the register
+	 * as they are copied, so the data is only read once
+	 * @param  {ValueType} crc  : register
+	 * @param  {uint8_t*} const : destination
+	 * @param  {uint8_t*} const : source
+	 * @param  {size_t} len     :
+	 * @return {ValueType}      : register
+	 */
+	static ValueType updateCopy(
+		ValueType crc,
+		uint8_t* const dst,
+		const uint8_t* const src,
+		const size_t len) noexcept {
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+			for(size_t i = 0; i < len; ++i) {
+				const uint8_t b = src[i];
+				dst[i] = b;
+				crc = CrcAvrLibc<Width, Poly, Reflect>::AVAILABLE
+					? CrcAvrLibc<Width, Poly, Reflect>::update(crc, b)
+					: updateBitwise(crc, &b, 1);
+			}
+			return crc;
+#else
+			//copy a block small enough to stay in L1, then checksum it
+			//with the fastest backend while it is there
+			const size_t blockLen = 256;
+
+			for(size_t i = 0; i < len; i += blockLen) {
+				const size_t n = len - i < blockLen ? len - i : blockLen;
+				::memcpy(dst + i, src + i, n);
+				crc = update(crc, dst + i, n);
+			}
+
+			return crc;
+#endif
+
+	}
+
+	/**
+	 * Register after shifting len zero bytes through crc. Takes one
+	 * multiplication per set bit of len rather than O(len) updates.
+	 * @param  {ValueType} crc : register
+	 * @param  {size_t} len    :
+	 * @return {ValueType}     : register
+	 */
+	static ValueType shift(ValueType crc, size_t len) noexcept {
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		//square as we go rather than spend RAM on a table of powers
+		ValueType p = _Math::zeros(0);
+
+		while(len > 0) {
+			if(len & 1) {
+				crc = _multiply(crc, p);
+			}
+			p = _multiply(p, p);
+			len >>= 1;
+		}
+#else
+		const ValueType* const zeros = _Tables::ZEROS.v;
+
+		for(size_t k = 0; len > 0; ++k, len >>= 1) {
+			if(len & 1) {
+				crc = _multiply(crc, zeros[k]);
+			}
+		}
+#endif
+
+		return crc;
+
+	}
+
+	/**
+	 * Register after updating with A then B, where crcA is the register
+	 * after A and crcB is the register after B starting from zero. Lets a
+	 * CRC over A and B be recalculated when only A changes without
+	 * rescanning B.
+	 * @param  {ValueType} crcA : register after A
+	 * @param  {ValueType} crcB : register after B, starting from zero
+	 * @param  {size_t} lenB    : length of B
+	 * @return {ValueType}      : register
+	 */
+	static ValueType combine(const ValueType crcA, const ValueType crcB, const size_t lenB) noexcept {
+		return shift(crcA, lenB) ^ crcB;
+	}
+
+	/**
+	 * Calculate the CRC of data
+	 * @param  {uint8_t*} const :
+	 * @param  {size_t} len     :
+	 * @return {ValueType}      :
+	 */
+	static ValueType compute(const uint8_t* const data, const size_t len) noexcept {
+		return finalize(update(init(), data, len));
+	}
+
+};
+
+/**
+ * CRC-8 (poly 0x07), as avr-libc's _crc8_ccitt_update; RadioPacket checksums
+ */
+typedef Crc<8, 0x07, 0x00, false, 0x00> Crc8Ccitt;
+
+/**
+ * CRC-16 (poly 0x1021 reflected, init 0xffff), as avr-libc's _crc_ccitt_update
+ */
+typedef Crc<16, 0x1021, 0xffff, true, 0x0000> Crc16Ccitt;
+
+/**
+ * CRC-8 (poly 0x4d reflected, init 0xff, xorout 0xff), as Util::crc8_slow
+ * and Util::crc8_fast
+ */
+typedef Crc<8, 0x4d, 0xff, true, 0xff> Crc8Poly4D;
+
+};
+
+#endif
@@ -27,32 +27,29 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "Storage.h"
 #include "Util.h"
 
 namespace RadioPacket {
-template<class StorageType = uint8_t, class IndexType = size_t>
+template<class StorageType = uint8_t, class IndexType = size_t, class Storage = HeapStorage>
 class ExpandingArray {
 
 protected:
 
 	/**
-	 * Underlying contiguous array of data
+	 * Underlying contiguous array of data; where it lives and how large
+	 * it may grow is decided by the Storage policy
 	 */
-	StorageType* _data = nullptr;
+	typename Storage::template Buffer<StorageType, IndexType> _storage;
 
 	/**
 	 * Length of data within the array
 	 */
 	IndexType _currentLength = 0;
 
-	/**
-	 * Length of the underlying array; hidden from calling code
-	 */
-	IndexType _arrayLength = 0;
-
 	
 	inline bool _indexInRange(const IndexType i) const noexcept {
-		return this->_data != nullptr &&
+		return this->_storage.data() != nullptr &&
 			i >= 0 &&
 			i < this->_currentLength;
 	}
@@ -79,7 +76,45 @@ public:
 	 */
 	ExpandingArray(const ExpandingArray& a) noexcept {
 		this->resize(a._currentLength, false);
-		this->copyFrom(a._data, a._currentLength);
+		this->copyFrom(a._storage.data(), a._currentLength);
+	}
+
+	/**
+	 * Move constructor - takes a's array, leaving a empty
+	 */
+	ExpandingArray(ExpandingArray&& a) noexcept {
+		this->_storage.take(a._storage, a._currentLength);
+		this->_currentLength = a._currentLength;
+		a._currentLength = 0;
+	}
+
+	/**
+	 * Copy assignment - deep copy
+	 */
+	ExpandingArray& operator=(const ExpandingArray& a) noexcept {
+
+		if(this != &a) {
+			this->resize(a._currentLength, false);
+			this->copyFrom(a._storage.data(), a._currentLength);
+		}
+
+		return *this;
+
+	}
+
+	/**
+	 * Move assignment - takes a's array, leaving a empty
+	 */
+	ExpandingArray& operator=(ExpandingArray&& a) noexcept {
+
+		if(this != &a) {
+			this->_storage.take(a._storage, a._currentLength);
+			this->_currentLength = a._currentLength;
+			a._currentLength = 0;
+		}
+
+		return *this;
+
 	}
 
 	/**
@@ -90,51 +125,57 @@ public:
 	}
 
 	StorageType& operator[](const IndexType i) {
-		return this->_data[i];
+		return this->_storage.data()[i];
 	}
 
 	const StorageType& operator[](const IndexType i) const {
-		return this->_data[i];
+		return this->_storage.data()[i];
 	}
 
 	/**
 	 * Allocate memory without increasing the current length, optionally
 	 * copying existing data
+	 * 
+	 * Returns false if the storage policy cannot hold len elements
 	 */
-	void allocate(const IndexType len, const bool copy = true, const bool zero = false) noexcept {
+	bool allocate(const IndexType len, const bool copy = true, const bool zero = false) noexcept {
 
 		//lengths < 0 not permitted
 		if(len < 0) {
-			return;
+			return false;
 		}
 
 		//cannot allocate less memory than amount of existing data
 		//but allocation is allowed if internal array is currently unallocated
-		if(len <= this->_currentLength && this->_data != nullptr) {
-			return;
+		if(len <= this->_currentLength && this->_storage.data() != nullptr) {
+			return true;
 		}
 
-		//allocate
-		//no need to initialise the elements
-		StorageType* arr = new StorageType[len];
-
 		//copy existing data if requested
-		if(copy) {
-			this->copyTo(arr, this->_currentLength);
-		}
-
 		//zero existing data if requested
-		if(zero) {
-			Util::zero(this->_data, this->_arrayLength);
-		}
+		return this->_storage.reallocate(
+			len,
+			copy ? this->_currentLength : 0,
+			zero);
+
+	}
+	
+	/**
+	 * Ensure the array can hold at least len elements without reallocating,
+	 * keeping existing data and the current length
+	 * 
+	 * Returns false if the storage policy cannot hold len elements
+	 */
+	bool reserve(const IndexType len) noexcept {
 
-		delete[] this->_data;
+		if(len <= this->_storage.capacity() && this->_storage.data() != nullptr) {
+			return true;
+		}
 
-		this->_data = arr;
-		this->_arrayLength = len;
+		return this->allocate(len, true);
 
 	}
-	
+
 	/**
 	 * Clears the array of elements
 	 * 
@@ -144,8 +185,8 @@ public:
 		
 		this->_currentLength = 0;
 
-		if(zero) {
-			Util::zero(this->_data, this->_arrayLength);
+		if(zero && this->_storage.data() != nullptr) {
+			Util::zero(this->_storage.data(), this->_storage.capacity() * sizeof(StorageType));
 		}
 
 	}
@@ -157,7 +198,7 @@ public:
 	 */
 	void dispose(const bool safe = false) noexcept {
 		this->clear(safe);
-		delete[] this->_data;
+		this->_storage.release();
 	}
 
 	/**
@@ -170,21 +211,14 @@ public:
 	void reclaim(const bool zero = false) noexcept {
 
 		//do nothing if already at capacity
-		if(this->_arrayLength <= this->_currentLength) {
+		if(this->_storage.capacity() <= this->_currentLength) {
 			return;
 		}
 
-		StorageType* arr = new StorageType[this->_currentLength];
-		this->copyTo(arr);
-
-		if(zero) {
-			Util::zero(this->_data, this->_currentLength);
-		}
-
-		delete[] this->_data;
-
-		this->_data = arr;
-		this->_arrayLength = this->_currentLength;
+		this->_storage.reallocate(
+			this->_currentLength,
+			this->_currentLength,
+			zero);
 
 	}
 
@@ -195,32 +229,39 @@ public:
 		return this->_currentLength;
 	}
 
+	/**
+	 * Number of elements the array can hold without allocating
+	 */
+	IndexType capacity() const noexcept {
+		return this->_storage.capacity();
+	}
+
 	/**
 	 * Returns a pointer to the element by its index
 	 */
 	StorageType* ptr(const IndexType i = 0) noexcept {
-		return this->_data != nullptr ? &this->_data[i] : nullptr;
+		return this->_storage.data() != nullptr ? &this->_storage.data()[i] : nullptr;
 	}
 
 	/**
 	 * Returns a constant pointer to the element by its index
 	 */
 	const StorageType* ptr(const IndexType i = 0) const noexcept {
-		return this->_data != nullptr ? &this->_data[i] : nullptr;
+		return this->_storage.data() != nullptr ? &this->_storage.data()[i] : nullptr;
 	}
 
 	/**
 	 * Returns a pointer to the end of the array
 	 */
 	StorageType* end() noexcept {
-		return &this->_data[this->_currentLength];
+		return &this->_storage.data()[this->_currentLength];
 	}
 
 	/**
 	 * Returns a constant pointer to the end of the array
 	 */
 	const StorageType* end() const noexcept {
-		return &this->_data[this->_currentLength];
+		return &this->_storage.data()[this->_currentLength];
 	}
 
 	/**
@@ -230,11 +271,11 @@ public:
 	 */
 	IndexType idx(const StorageType* const ptr) const noexcept {
 		
-		if(this->_data == nullptr || ptr == nullptr) {
+		if(this->_storage.data() == nullptr || ptr == nullptr) {
 			return -1;
 		}
 
-		return ptr - this->_data;
+		return ptr - this->_storage.data();
 
 	}
 
@@ -254,17 +295,23 @@ public:
 			return;
 		}
 
-		//bug?
-		if(!this->_indexInRange(i)) {
+		//copying may start at the end of the array (ie. append)
+		//but no further
+		if(i > this->_currentLength) {
 			return;
 		}
 
 		//if copying len data will exceed the size of the array, resize
 		if((i + len) > this->_currentLength) {
-			this->resize(this->_currentLength + (this->_currentLength - (i + len)), true);
+			this->resize(i + len, true);
+		}
+
+		//resizing may not have been possible
+		if((i + len) > this->_currentLength) {
+			return;
 		}
 
-		::memcpy(&this->_data[i], data, len);
+		::memcpy(&this->_storage.data()[i], data, len);
 
 	}
 
@@ -294,13 +341,19 @@ public:
 			return;
 		}
 
-		::memcpy(data, &this->_data[i], len);
+		::memcpy(data, &this->_storage.data()[i], len);
 
 	}
 
 	/**
 	 * Resize the array to the given length, optionally copying existing data
 	 * to the newly resized array
+	 * 
+	 * When growing beyond the current capacity, the storage policy may
+	 * allocate more than len so that subsequent growth does not reallocate
+	 * 
+	 * The length is left unchanged if the storage policy cannot hold len
+	 * elements
 	 */
 	void resize(const IndexType len, const bool copy = true) noexcept {
 
@@ -310,20 +363,21 @@ public:
 		}
 
 		//do nothing if same size AND unallocated
-		if(len == this->_currentLength && this->_data != nullptr) {
+		if(len == this->_currentLength && this->_storage.data() != nullptr) {
 			return;
 		}
-		else if(len < this->_arrayLength) {
+		else if(len <= this->_storage.capacity() && this->_storage.data() != nullptr) {
 			//if the array is currently able to hold len amount of data,
 			//just update the length and return
 			this->_currentLength = len;
 			return;
 		}
 
-		//otherwise, allocate len amount of data
+		//otherwise, allocate at least len amount of data
 		//and set the new length
-		this->allocate(len, copy);
-		this->_currentLength = len;
+		if(this->allocate(this->_storage.grow(len), copy)) {
+			this->_currentLength = len;
+		}
 
 	}
 
@@ -0,0 +1,226 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef FEC_CODEC_H_5CCA1DC3_25AE_4C5E_9F93_AC5343E4646B
+#define FEC_CODEC_H_5CCA1DC3_25AE_4C5E_9F93_AC5343E4646B
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "RadioPacket.h"
+#include "ReedSolomon.h"
+
+/**
+ * Forward error correction for whole frames, so that a frame with a few
+ * corrupted bytes is repaired by the receiver rather than dropped.
+ *
+ * An encoded packet has Reed-Solomon parity appended, and the two are
+ * transmitted as one frame:
+ *
+ * 	[PACKET, len bytes][PARITY, Depth * ParityLength bytes]
+ *
+ * The frame is made of Depth interleaved codewords: byte i of the frame,
+ * whether packet or parity, belongs to codeword i % Depth. Each codeword
+ * corrects ParityLength / 2 corrupted bytes, so a burst of noise up to
+ * Depth * ParityLength / 2 bytes long is corrected wherever it falls.
+ * Interleaving also keeps each codeword within the 255 bytes
+ * Reed-Solomon allows.
+ *
+ * The packet header is covered like any other byte, so the receiver needs
+ * nothing but the frame's length as received to decode it. Both ends must
+ * use the same ParityLength and Depth. A frame with more errors than can
+ * be corrected is almost always reported as such; the packet's CRC8
+ * catches the rest.
+ *
+ * Frames are for links which deliver each frame with its length, such as
+ * a packet radio; a StreamDeframer does not find them in a byte stream.
+ *
+ * 	typedef FecCodec<8, 2> Fec;
+ * 	uint8_t frame[Fec::getMaxFrameLength()];
+ *
+ * 	const uint8_t len = e.encodeMessage(frame, UPDATE_DB_CMD, arr, sizeof(arr));
+ * 	man.transmitArray(Fec::encode(frame, len), frame);
+ *
+ * 	//receiver
+ * 	uint8_t len;
+ *
+ * 	if(Fec::decode(frame, frameLen, &len) == ReedSolomon::DECODE_OK &&
+ * 		RadioPacketView::parse(&p, frame, len) == RadioPacket::PARSE_OK) {
+ * 			//use p
+ * 	}
+ */
+namespace RadioPacket {
+
+template<uint8_t ParityLength = 8, uint8_t Depth = 2>
+class FecCodec {
+
+	static_assert(ParityLength > 0 && ParityLength <= ReedSolomon::MAX_PARITY_LENGTH,
+		"FecCodec parity length must be from 1 to ReedSolomon::MAX_PARITY_LENGTH");
+	static_assert(Depth > 0, "FecCodec depth must be at least 1");
+
+protected:
+
+	static const uint16_t _CODEWORD_PACKET_LEN =
+		static_cast<uint16_t>(Depth) * (0xff - ParityLength);
+
+	/**
+	 * Number of packet bytes in codeword i
+	 */
+	static inline uint8_t _codewordLength(const uint8_t packetLen, const uint8_t i) noexcept {
+		return packetLen > i
+			? static_cast<uint8_t>((packetLen - i + Depth - 1) / Depth)
+			: 0;
+	}
+
+	/**
+	 * Offset in the frame of codeword i's first parity byte
+	 */
+	static inline uint16_t _parityOffset(const uint8_t packetLen, const uint8_t i) noexcept {
+		return packetLen + (i + Depth - packetLen % Depth) % Depth;
+	}
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	FecCodec();
+
+
+public:
+
+	/**
+	 * Longest packet which can be encoded; the longest possible packet
+	 * unless Depth is 1
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getMaxPacketLength() noexcept {
+		return _CODEWORD_PACKET_LEN < RadioPacket::getMaxPacketLength()
+			? static_cast<uint8_t>(_CODEWORD_PACKET_LEN)
+			: RadioPacket::getMaxPacketLength();
+	}
+
+	/**
+	 * Number of parity bytes appended to every frame
+	 * @return {uint16_t}  :
+	 */
+	static constexpr uint16_t getParityLength() noexcept {
+		return static_cast<uint16_t>(Depth) * ParityLength;
+	}
+
+	/**
+	 * Space needed for the longest frame
+	 * @return {uint16_t}  :
+	 */
+	static constexpr uint16_t getMaxFrameLength() noexcept {
+		return getMaxPacketLength() + getParityLength();
+	}
+
+	/**
+	 * Append parity to the len byte packet at the start of frame and
+	 * return the frame's length, or 0 if len exceeds getMaxPacketLength().
+	 * Calling code must ensure frame has len + getParityLength() bytes
+	 * of space
+	 * @param  {uint8_t*} const : packet, followed by space for parity
+	 * @param  {uint8_t} len    : packet length
+	 * @return {uint16_t}       : frame length
+	 */
+	static uint16_t encode(uint8_t* const frame, const uint8_t len) noexcept {
+
+		if(len > getMaxPacketLength()) {
+			return 0;
+		}
+
+		for(uint8_t i = 0; i < Depth; ++i) {
+			ReedSolomon::encode(
+				frame + i,
+				_codewordLength(len, i),
+				frame + _parityOffset(len, i),
+				ParityLength,
+				Depth);
+		}
+
+		return len + getParityLength();
+
+	}
+
+	/**
+	 * Correct a frame in place and set len to the length of the packet at
+	 * its start. If any codeword cannot be corrected, the frame must be
+	 * discarded.
+	 * @param  {uint8_t*} const     : frame as received
+	 * @param  {uint16_t} frameLen   : frame length as received
+	 * @param  {uint8_t*} const     : set to the packet length
+	 * @param  {uint16_t*} corrected : set to the number of bytes corrected; may be nullptr
+	 * @return {uint8_t}             : one of the ReedSolomon::DECODE_* constants
+	 */
+	static uint8_t decode(
+		uint8_t* const frame,
+		const uint16_t frameLen,
+		uint8_t* const len,
+		uint16_t* const corrected = nullptr) noexcept {
+
+			if(corrected != nullptr) {
+				*corrected = 0;
+			}
+
+			if(frameLen <= getParityLength() ||
+				frameLen - getParityLength() > getMaxPacketLength()) {
+					return ReedSolomon::DECODE_ERROR_INVALID_LENGTH;
+			}
+
+			const uint8_t packetLen = static_cast<uint8_t>(frameLen - getParityLength());
+			uint16_t total = 0;
+
+			for(uint8_t i = 0; i < Depth; ++i) {
+
+				uint8_t n;
+				const uint8_t status = ReedSolomon::decode(
+					frame + i,
+					_codewordLength(packetLen, i),
+					frame + _parityOffset(packetLen, i),
+					ParityLength,
+					Depth,
+					&n);
+
+				if(status != ReedSolomon::DECODE_OK) {
+					return status;
+				}
+
+				total += n;
+
+			}
+
+			*len = packetLen;
+
+			if(corrected != nullptr) {
+				*corrected = total;
+			}
+
+			return ReedSolomon::DECODE_OK;
+
+	}
+
+};
+};
+
+#endif
@@ -0,0 +1,173 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "Fragmenter.h"
+
+#include <string.h>
+
+#include "Crc.h"
+
+namespace RadioPacket {
+
+void Fragmenter::_countFragments() noexcept {
+
+	const uint8_t maxBodyLen = this->_encoder.getMaxBodyLength();
+
+	//with parity, the last fragment number is taken by the parity fragment
+	const uint8_t maxFragments = this->_parity ? 0xff - 1 : 0xff;
+
+	this->_fragmentCount = this->_len > static_cast<uint16_t>(maxFragments) * maxBodyLen
+		? 0
+		: Fragmenter::calculateFragmentCount(this->_len, maxBodyLen);
+
+}
+
+uint8_t Fragmenter::_nextParity(uint8_t* const buff) noexcept {
+
+	const PacketFormat* const format = this->_encoder.getFormat();
+	const uint8_t maxBodyLen = this->_encoder.getMaxBodyLength();
+	uint8_t* const body = buff + format->headerLength;
+
+	::memset(body, 0, maxBodyLen);
+
+	for(uint16_t offset = 0; offset < this->_len; offset += maxBodyLen) {
+
+		const uint16_t remaining = this->_len - offset;
+		const uint8_t n = remaining > maxBodyLen
+			? maxBodyLen
+			: static_cast<uint8_t>(remaining);
+
+		for(uint8_t i = 0; i < n; ++i) {
+			body[i] ^= this->_data[offset + i];
+		}
+
+	}
+
+	this->_encoder.setRawFragmentNumber(PARITY_FRAGMENT_NUMBER);
+
+	//the body is already in place after the header
+	uint8_t crc = this->_encoder._writeHeader(buff, maxBodyLen);
+	crc = Crc8Ccitt::update(crc, body, maxBodyLen);
+	buff[format->crc8Offset] = Crc8Ccitt::finalize(crc);
+
+	return format->headerLength + maxBodyLen;
+
+}
+
+uint8_t Fragmenter::calculateFragmentCount(const uint16_t len, const uint8_t maxBodyLength) noexcept {
+
+	if(len == 0) {
+		return 1;
+	}
+
+	return static_cast<uint8_t>((len + maxBodyLength - 1) / maxBodyLength);
+
+}
+
+Fragmenter::Fragmenter(const uint8_t* const data, const uint16_t len) noexcept
+	: _data(data), _len(len) {
+		this->_countFragments();
+}
+
+Fragmenter::Fragmenter(const Message* msg) noexcept
+	: Fragmenter(msg->getData(), msg->getMessageLength()) {
+}
+
+void Fragmenter::setRawVersion(const uint8_t version) noexcept {
+	this->_encoder.setRawVersion(version);
+	this->_countFragments();
+}
+
+bool Fragmenter::setRawTransmitterId(const uint16_t id) noexcept {
+	return this->_encoder.setRawTransmitterId(id);
+}
+
+bool Fragmenter::setRawReceiverId(const uint16_t id) noexcept {
+	return this->_encoder.setRawReceiverId(id);
+}
+
+void Fragmenter::setRawMessageId(const uint16_t id) noexcept {
+	this->_encoder.setRawMessageId(id);
+}
+
+void Fragmenter::setRawSequenceNumber(const uint16_t n) noexcept {
+	this->_encoder.setRawSequenceNumber(n);
+}
+
+void Fragmenter::setParity(const bool parity) noexcept {
+	this->_parity = parity;
+	this->_countFragments();
+}
+
+uint8_t Fragmenter::getFragmentCount() const noexcept {
+	return this->_parity && this->_fragmentCount > 1
+		? this->_fragmentCount + 1
+		: this->_fragmentCount;
+}
+
+uint8_t Fragmenter::getNextFragmentNumber() const noexcept {
+	return this->_fragment < this->_fragmentCount
+		? this->_fragment + 1
+		: PARITY_FRAGMENT_NUMBER;
+}
+
+bool Fragmenter::hasNext() const noexcept {
+	return this->_fragment < this->getFragmentCount();
+}
+
+uint8_t Fragmenter::next(uint8_t* const buff) noexcept {
+
+	if(!this->hasNext()) {
+		return 0;
+	}
+
+	if(this->_fragment == this->_fragmentCount) {
+		++this->_fragment;
+		return this->_nextParity(buff);
+	}
+
+	const uint16_t remaining = this->_len - this->_offset;
+	const uint8_t maxBodyLen = this->_encoder.getMaxBodyLength();
+	const uint8_t bodyLen = remaining > maxBodyLen
+		? maxBodyLen
+		: static_cast<uint8_t>(remaining);
+
+	this->_encoder.setRawFragmentNumber(++this->_fragment);
+
+	const uint8_t packetLen = this->_encoder.encode(
+		buff,
+		this->_data + this->_offset,
+		bodyLen);
+
+	this->_offset += bodyLen;
+
+	return packetLen;
+
+}
+
+void Fragmenter::rewind() noexcept {
+	this->_offset = 0;
+	this->_fragment = 0;
+}
+
+};
@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FRAGMENTER_H_11621EDC_1701_4C2E_AB17_0BE249528BFE
+#define FRAGMENTER_H_11621EDC_1701_4C2E_AB17_0BE249528BFE
+
+#include <stdint.h>
+
+#include "Message.h"
+#include "PacketEncoder.h"
+#include "RadioPacket.h"
+
+/**
+ * A Fragmenter splits data too large for a single RadioPacket into a
+ * sequence of packets, one at a time.
+ *
+ * Each call to next() encodes the next complete packet (header, fragment
+ * number, body length and CRC) into a caller-supplied buffer of at least
+ * RadioPacket::getMaxPacketLength() bytes with a PacketEncoder, ready to
+ * be transmitted. Only one packet exists at any time, so the data is
+ * never materialised as packets and nothing is allocated.
+ *
+ * Fragments are numbered from 1. Every fragment but the last carries as
+ * much data as the header's version allows (RadioPacket::getMaxBodyLength()
+ * bytes for version 1). When fragmenting a Message, the first fragment
+ * begins with the Message header, so a receiver can tell from it how many
+ * fragments to expect. With a version 2 header, every fragment also
+ * carries the message ID set with setRawMessageId, so a receiver can tell
+ * one message's fragments from another's.
+ *
+ * With setParity, a parity fragment follows the last, numbered
+ * PARITY_FRAGMENT_NUMBER. Its body is the XOR of every fragment's body,
+ * each padded with zeros to the length of the first, so a Reassembler
+ * which has every fragment but one can rebuild the one it lost.
+ *
+ * The data is read in place; it must outlive the Fragmenter and must not
+ * be modified while fragments are being produced.
+ *
+ * 	uint8_t buff[RadioPacket::getMaxPacketLength()];
+ * 	Fragmenter f(&m);
+ * 	uint8_t len;
+ *
+ * 	while((len = f.next(buff)) > 0) {
+ * 		man.transmitArray(len, buff);
+ * 	}
+ */
+namespace RadioPacket {
+class Fragmenter {
+
+protected:
+
+	const uint8_t* _data = nullptr;
+	uint16_t _len = 0;
+	uint16_t _offset = 0;
+	uint8_t _fragment = 0;
+	uint8_t _fragmentCount = 0;
+	bool _parity = false;
+
+	/**
+	 * Holds the header shared by every fragment
+	 */
+	PacketEncoder _encoder;
+
+	/**
+	 * Count the fragments needed with the encoder's current version
+	 */
+	void _countFragments() noexcept;
+
+	/**
+	 * Write the parity fragment into buff and return its length
+	 */
+	uint8_t _nextParity(uint8_t* const buff) noexcept;
+
+
+public:
+
+	/**
+	 * Fragment number of the parity fragment; data fragments are numbered
+	 * below it
+	 */
+	static const uint8_t PARITY_FRAGMENT_NUMBER = 0xff;
+
+	/**
+	 * Largest number of bytes which can be fragmented with a version 1
+	 * header, as the fragment number is a single byte
+	 * @return {uint16_t}  :
+	 */
+	static constexpr uint16_t getMaxDataLength() noexcept {
+		return static_cast<uint16_t>(0xff) * RadioPacket::getMaxBodyLength();
+	}
+
+	/**
+	 * Number of fragments needed to carry len bytes; an empty body still
+	 * needs one
+	 * @param  {uint16_t} len          :
+	 * @param  {uint8_t} maxBodyLength : data carried by each fragment
+	 * @return {uint8_t}               :
+	 */
+	static uint8_t calculateFragmentCount(
+		const uint16_t len,
+		const uint8_t maxBodyLength = RadioPacket::getMaxBodyLength()) noexcept;
+
+	/**
+	 * Fragment len bytes of data
+	 * If len needs more than 255 fragments, no fragments are produced
+	 * @param  {uint8_t*} const :
+	 * @param  {uint16_t} len   :
+	 */
+	Fragmenter(const uint8_t* const data, const uint16_t len) noexcept;
+
+	/**
+	 * Fragment a Message, including its header
+	 * @param  {Message*} msg :
+	 */
+	Fragmenter(const Message* msg) noexcept;
+
+	Fragmenter(const Fragmenter& f) noexcept = default;
+	Fragmenter& operator=(const Fragmenter& f) noexcept = default;
+
+	/**
+	 * Set the version of every fragment's header; as this changes how
+	 * much data each fragment carries, call it before next()
+	 * @param  {uint8_t} version :
+	 */
+	void setRawVersion(const uint8_t version) noexcept;
+
+	/**
+	 * See PacketEncoder::setRawTransmitterId
+	 */
+	bool setRawTransmitterId(const uint16_t id) noexcept;
+	bool setRawReceiverId(const uint16_t id) noexcept;
+
+	/**
+	 * Ignored if the version has no message ID
+	 * @param  {uint16_t} id :
+	 */
+	void setRawMessageId(const uint16_t id) noexcept;
+
+	/**
+	 * Set the sequence number of the next fragment; see
+	 * PacketEncoder::setRawSequenceNumber
+	 * @param  {uint16_t} n :
+	 */
+	void setRawSequenceNumber(const uint16_t n) noexcept;
+
+	/**
+	 * Follow the last fragment with a parity fragment. Data which fits in
+	 * a single fragment has none. With parity, data is limited to 254
+	 * fragments. Call it before next().
+	 * @param  {bool} parity :
+	 */
+	void setParity(const bool parity) noexcept;
+
+	/**
+	 * Total number of fragments, including any parity fragment; 0 if the
+	 * data is too long to fragment
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getFragmentCount() const noexcept;
+
+	/**
+	 * Number of the fragment the next call to next() will produce;
+	 * PARITY_FRAGMENT_NUMBER for the parity fragment
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getNextFragmentNumber() const noexcept;
+
+	/**
+	 * Whether there are fragments left to produce
+	 * @return {bool}  :
+	 */
+	bool hasNext() const noexcept;
+
+	/**
+	 * Write the next fragment into buff and return its length in bytes,
+	 * or 0 if every fragment has been produced.
+	 * Calling code must ensure buff has RadioPacket::getMaxPacketLength()
+	 * bytes of space
+	 * @param  {uint8_t*} const : 
+	 * @return {uint8_t}        : length of the fragment written to buff
+	 */
+	uint8_t next(uint8_t* const buff) noexcept;
+
+	/**
+	 * Start again from the first fragment, eg. to retransmit
+	 */
+	void rewind() noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,213 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef FRAME_RING_H_64E54E12_EC25_43AC_BB9A_C52EE3C23B44
+#define FRAME_RING_H_64E54E12_EC25_43AC_BB9A_C52EE3C23B44
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Atomic.h"
+#include "Meta.h"
+#include "Platform.h"
+#include "RadioPacket.h"
+
+/**
+ * Lock-free single-producer, single-consumer ring of fixed-size frame
+ * slots, to decouple receiving frames from parsing them.
+ *
+ * The producer (eg. a receive-complete ISR, or a reader thread) claims a
+ * slot, receives directly into it and commits it with the frame's length.
+ * The consumer (eg. loop(), or a worker thread) parses the oldest
+ * committed frame in place and then releases its slot. Nothing is copied
+ * and neither side ever waits for the other.
+ *
+ * 	uint8_t* const slot = ring.claim();		//producer
+ * 	//receive up to FrameRing::getSlotSize() bytes into slot
+ * 	ring.commit(len);
+ *
+ * 	size_t len;								//consumer
+ * 	const uint8_t* const frame = ring.front(&len);
+ *
+ * 	if(frame != nullptr) {
+ * 		RadioPacketView::parse(&p, frame, len);
+ * 		ring.release();
+ * 	}
+ *
+ * Exactly one context may call the producer functions and exactly one
+ * other the consumer functions.
+ */
+namespace RadioPacket {
+
+template<size_t Slots, size_t SlotSize = RadioPacket::getMaxPacketLength()>
+class FrameRing {
+
+	static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0,
+		"FrameRing slot count must be a power of 2");
+	static_assert(SlotSize > 0, "FrameRing slots must hold at least one byte");
+
+protected:
+
+	/**
+	 * Free-running counters; they wrap harmlessly since Slots divides
+	 * the counter's range. A single byte where possible so AVR accesses
+	 * them cheaply.
+	 */
+	typedef typename Meta::Conditional<(Slots <= 128), uint8_t, size_t>::Type IndexType;
+
+	typedef typename Meta::Conditional<(SlotSize <= 0xff), uint8_t,
+		typename Meta::Conditional<(SlotSize <= 0xffff), uint16_t, size_t>::Type>::Type LengthType;
+
+	uint8_t _slots[Slots][SlotSize];
+	LengthType _lengths[Slots];
+
+	/**
+	 * Written by the consumer
+	 */
+	RADIOPACKET_CACHE_ALIGNED Atomic<IndexType> _head;
+	IndexType _tailCache = 0;
+
+	/**
+	 * Written by the producer
+	 */
+	RADIOPACKET_CACHE_ALIGNED Atomic<IndexType> _tail;
+	IndexType _headCache = 0;
+	Atomic<uint32_t> _overruns;
+
+
+public:
+
+	FrameRing() noexcept
+		: _head(0), _tail(0), _overruns(0) {
+	}
+
+	FrameRing(const FrameRing& r) = delete;
+	FrameRing& operator=(const FrameRing& r) = delete;
+
+	static constexpr size_t capacity() noexcept {
+		return Slots;
+	}
+
+	static constexpr size_t getSlotSize() noexcept {
+		return SlotSize;
+	}
+
+	/**
+	 * Producer: returns the next free slot to receive a frame into, or
+	 * nullptr if every slot is waiting to be parsed. Claiming again before
+	 * committing returns the same slot.
+	 * @return {uint8_t*}  : getSlotSize() bytes
+	 */
+	uint8_t* claim() noexcept {
+
+		const IndexType tail = this->_tail.loadRelaxed();
+
+		//only look at the consumer's index when the cached copy says the
+		//ring is full
+		if(static_cast<IndexType>(tail - this->_headCache) == Slots) {
+
+			this->_headCache = this->_head.load();
+
+			if(static_cast<IndexType>(tail - this->_headCache) == Slots) {
+				this->_overruns.store(this->_overruns.loadRelaxed() + 1);
+				return nullptr;
+			}
+
+		}
+
+		return this->_slots[tail & (Slots - 1)];
+
+	}
+
+	/**
+	 * Producer: publish the slot returned by claim, holding a frame of
+	 * len bytes, to the consumer
+	 * @param  {size_t} len : at most getSlotSize()
+	 */
+	void commit(const size_t len) noexcept {
+
+		const IndexType tail = this->_tail.loadRelaxed();
+
+		this->_lengths[tail & (Slots - 1)] = static_cast<LengthType>(
+			len < SlotSize ? len : SlotSize);
+
+		this->_tail.store(static_cast<IndexType>(tail + 1));
+
+	}
+
+	/**
+	 * Consumer: returns the oldest committed frame and sets len to its
+	 * length, or returns nullptr if there is none. The frame is left in
+	 * place until release is called.
+	 * @param  {size_t*} const :
+	 * @return {uint8_t*}      :
+	 */
+	const uint8_t* front(size_t* const len) noexcept {
+
+		const IndexType head = this->_head.loadRelaxed();
+
+		if(head == this->_tailCache) {
+
+			this->_tailCache = this->_tail.load();
+
+			if(head == this->_tailCache) {
+				return nullptr;
+			}
+
+		}
+
+		*len = this->_lengths[head & (Slots - 1)];
+
+		return this->_slots[head & (Slots - 1)];
+
+	}
+
+	/**
+	 * Consumer: hand the frame returned by front back to the producer
+	 */
+	void release() noexcept {
+		this->_head.store(static_cast<IndexType>(this->_head.loadRelaxed() + 1));
+	}
+
+	/**
+	 * Number of committed frames waiting to be parsed; exact only when
+	 * called by the consumer
+	 * @return {size_t}  :
+	 */
+	size_t size() const noexcept {
+		return static_cast<IndexType>(this->_tail.load() - this->_head.load());
+	}
+
+	/**
+	 * Number of times claim found every slot full
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getOverrunCount() const noexcept {
+		return this->_overruns.load();
+	}
+
+};
+
+};
+
+#endif
@@ -0,0 +1,223 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "LzCodec.h"
+
+namespace RadioPacket {
+
+LzEncoder::LzEncoder() {
+}
+
+size_t LzEncoder::encode(
+	const uint8_t* const in,
+	const size_t len,
+	uint8_t* const out,
+	const size_t capacity,
+	const CompressionDictionary* const dict) noexcept {
+
+		//the dictionary and input are searched as one sequence, with the
+		//dictionary first
+		const uint8_t* const dictData = dict != nullptr ? dict->data : nullptr;
+		const size_t dictLen = dict == nullptr
+			? 0
+			: dict->length < _WINDOW_LEN ? dict->length : _WINDOW_LEN;
+		const uint8_t* const dictStart = dictData + (dict != nullptr ? dict->length - dictLen : 0);
+		const bool dictInFlash = dict != nullptr && dict->inFlash;
+		const size_t total = dictLen + len;
+
+		size_t o = 0;
+		size_t flagIndex = 0;
+		uint8_t flagBit = 8;
+
+		for(size_t j = dictLen; j < total;) {
+
+			if(flagBit == 8) {
+				if(o == capacity) {
+					return 0;
+				}
+				flagIndex = o++;
+				out[flagIndex] = 0;
+				flagBit = 0;
+			}
+
+			//longest match starting within the window; ties go to the
+			//nearest, as it is found last
+			const size_t maxLen = total - j < _MAX_MATCH ? total - j : _MAX_MATCH;
+			const size_t start = j > _WINDOW_LEN ? j - _WINDOW_LEN : 0;
+			const uint8_t first = in[j - dictLen];
+			size_t bestLen = 0;
+			size_t bestOffset = 0;
+
+			for(size_t k = start; k < j && maxLen >= _MIN_MATCH; ++k) {
+
+				if((k < dictLen ? _dictionaryByte(dictStart + k, dictInFlash) : in[k - dictLen]) != first) {
+					continue;
+				}
+
+				size_t n = 1;
+
+				//the match may run on into the bytes it is copying
+				while(n < maxLen &&
+					(k + n < dictLen ? _dictionaryByte(dictStart + k + n, dictInFlash) : in[k + n - dictLen]) == in[j + n - dictLen]) {
+						++n;
+				}
+
+				if(n >= bestLen) {
+					bestLen = n;
+					bestOffset = j - k;
+				}
+
+			}
+
+			if(bestLen >= _MIN_MATCH) {
+
+				if(o + 2 > capacity) {
+					return 0;
+				}
+
+				const uint16_t offset = static_cast<uint16_t>(bestOffset - 1);
+
+				out[flagIndex] |= static_cast<uint8_t>(1 << flagBit);
+				out[o++] = static_cast<uint8_t>(offset >> 4);
+				out[o++] = static_cast<uint8_t>(((offset & 0xf) << 4) | (bestLen - _MIN_MATCH));
+				j += bestLen;
+
+			}
+			else {
+
+				if(o == capacity) {
+					return 0;
+				}
+
+				out[o++] = first;
+				++j;
+
+			}
+
+			++flagBit;
+
+		}
+
+		return o;
+
+}
+
+LzDecoder::LzDecoder() noexcept {
+}
+
+void LzDecoder::reset(const CompressionDictionary* const dict) noexcept {
+
+	this->_position = 0;
+	this->_history = 0;
+	this->_flags = 0;
+	this->_flagBits = 0;
+	this->_haveMatchHigh = false;
+	this->_matchRemaining = 0;
+	this->_error = false;
+
+	if(dict == nullptr) {
+		return;
+	}
+
+	const uint16_t dictLen = dict->length < LzEncoder::_WINDOW_LEN
+		? dict->length
+		: LzEncoder::_WINDOW_LEN;
+	const uint8_t* const dictStart = dict->data + (dict->length - dictLen);
+
+	for(uint16_t i = 0; i < dictLen; ++i) {
+		this->_window[i] = LzEncoder::_dictionaryByte(dictStart + i, dict->inFlash);
+	}
+
+	this->_position = dictLen & (LzEncoder::_WINDOW_LEN - 1);
+	this->_history = dictLen;
+
+}
+
+size_t LzDecoder::decode(
+	const uint8_t* const in,
+	const size_t len,
+	size_t* const consumed,
+	uint8_t* const out,
+	const size_t capacity) noexcept {
+
+		size_t i = 0;
+		size_t o = 0;
+
+		while(o < capacity && !this->_error) {
+
+			if(this->_matchRemaining > 0) {
+				const uint16_t from = (this->_position - this->_matchOffset) & (LzEncoder::_WINDOW_LEN - 1);
+				this->_emit(out + o++, this->_window[from]);
+				--this->_matchRemaining;
+				continue;
+			}
+
+			if(i == len) {
+				break;
+			}
+
+			if(this->_flagBits == 0) {
+				this->_flags = in[i++];
+				this->_flagBits = 8;
+				continue;
+			}
+
+			if((this->_flags & 1) == 0) {
+				this->_emit(out + o++, in[i++]);
+				this->_flags >>= 1;
+				--this->_flagBits;
+				continue;
+			}
+
+			//a match is two bytes, which may arrive in separate chunks
+			if(!this->_haveMatchHigh) {
+				this->_matchHigh = in[i++];
+				this->_haveMatchHigh = true;
+				continue;
+			}
+
+			const uint8_t low = in[i++];
+
+			this->_matchOffset = static_cast<uint16_t>(((this->_matchHigh << 4) | (low >> 4)) + 1);
+			this->_matchRemaining = (low & 0xf) + LzEncoder::_MIN_MATCH;
+			this->_haveMatchHigh = false;
+			this->_flags >>= 1;
+			--this->_flagBits;
+
+			if(this->_matchOffset > this->_history) {
+				this->_error = true;
+			}
+
+		}
+
+		*consumed = i;
+
+		return o;
+
+}
+
+bool LzDecoder::isError() const noexcept {
+	return this->_error;
+}
+
+};
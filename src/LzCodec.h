@@ -0,0 +1,212 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef LZ_CODEC_H_4152559F_8995_4D45_97CA_52BC93B5DDD7
+#define LZ_CODEC_H_4152559F_8995_4D45_97CA_52BC93B5DDD7
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Platform.h"
+
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	#include <avr/pgmspace.h>
+#endif
+
+/**
+ * LZSS coding with an optional pre-shared dictionary.
+ *
+ * Data is coded as groups of up to eight tokens, each group introduced by
+ * a flag byte whose bits, least significant first, mark each token as a
+ * literal (0) or a match (1):
+ *
+ * 	LITERAL	| 1 byte	[ BYTE ]
+ * 	MATCH	| 2 bytes	[ OFFSET - 1, 12 bits ][ LENGTH - 3, 4 bits ]
+ *
+ * A match copies LENGTH (3 - 18) bytes starting OFFSET (1 - 4096) bytes
+ * back in the output. The dictionary is treated as if it came just before
+ * the data, so even a short message can refer to byte sequences both
+ * sides already know (eg. a typical reading, or a schema's field
+ * layout). Both sides must use the same dictionary.
+ *
+ * The encoder searches the dictionary and its input in place, so needs no
+ * RAM beyond the output; it spends CPU time instead, which suits small
+ * transmitters with an idle MCU and a slow radio. The decoder keeps the
+ * last 4096 bytes of output in a window of its own and is meant for a
+ * gateway.
+ */
+namespace RadioPacket {
+
+/**
+ * Bytes known to both encoder and decoder in advance. Only the last
+ * LzEncoder::getWindowLength() bytes can be referred to.
+ *
+ * On AVR a dictionary can stay in flash rather than take up RAM; declare
+ * it RADIOPACKET_PROGMEM and set inFlash, and it is read with
+ * pgm_read_byte. inFlash has no effect on a host.
+ *
+ * 	static const uint8_t DICT[] RADIOPACKET_PROGMEM = "temp=21.5;hum=40;";
+ * 	CompressionDictionary dict(DICT, sizeof(DICT) - 1, true);
+ */
+struct CompressionDictionary {
+
+	const uint8_t* data;
+	uint16_t length;
+	bool inFlash;
+
+	constexpr CompressionDictionary(
+		const uint8_t* const d,
+		const uint16_t len,
+		const bool flash = false) noexcept
+			: data(d), length(len), inFlash(flash) {
+	}
+
+};
+
+class LzEncoder {
+
+protected:
+
+	static const uint16_t _WINDOW_LEN = 4096;
+	static const uint8_t _MIN_MATCH = 3;
+	static const uint8_t _MAX_MATCH = 18;
+
+	/**
+	 * Read the dictionary byte at p, from flash if the dictionary is
+	 * kept there
+	 */
+	static inline uint8_t _dictionaryByte(const uint8_t* const p, const bool inFlash) noexcept {
+#if defined(RADIOPACKET_PLATFORM_AVR)
+		return inFlash ? pgm_read_byte(p) : *p;
+#else
+		(void)inFlash;
+		return *p;
+#endif
+	}
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	LzEncoder();
+
+	friend class LzDecoder;
+
+
+public:
+
+	static constexpr uint16_t getWindowLength() noexcept {
+		return _WINDOW_LEN;
+	}
+
+	/**
+	 * Encode len bytes of in into out and return the encoded length, or 0
+	 * if it would exceed capacity (an empty input also encodes to nothing)
+	 * @param  {uint8_t*} const              : 
+	 * @param  {size_t} len                  : 
+	 * @param  {uint8_t*} const              : 
+	 * @param  {size_t} capacity             : 
+	 * @param  {CompressionDictionary*} dict : nullptr for none
+	 * @return {size_t}                      : encoded length
+	 */
+	static size_t encode(
+		const uint8_t* const in,
+		const size_t len,
+		uint8_t* const out,
+		const size_t capacity,
+		const CompressionDictionary* const dict = nullptr) noexcept;
+
+};
+
+/**
+ * Decodes LZSS coded data fed in chunks of any size
+ */
+class LzDecoder {
+
+protected:
+
+	uint8_t _window[LzEncoder::_WINDOW_LEN];
+	uint16_t _position = 0;
+
+	//number of bytes behind _position a match may refer to
+	uint16_t _history = 0;
+
+	uint8_t _flags = 0;
+	uint8_t _flagBits = 0;
+	uint8_t _matchHigh = 0;
+	bool _haveMatchHigh = false;
+	uint16_t _matchOffset = 0;
+	uint8_t _matchRemaining = 0;
+	bool _error = false;
+
+	inline void _emit(uint8_t* const out, const uint8_t b) noexcept {
+		*out = b;
+		this->_window[this->_position] = b;
+		this->_position = (this->_position + 1) & (LzEncoder::_WINDOW_LEN - 1);
+		if(this->_history < LzEncoder::_WINDOW_LEN) {
+			++this->_history;
+		}
+	}
+
+
+public:
+
+	LzDecoder() noexcept;
+	LzDecoder(const LzDecoder& d) noexcept = default;
+	LzDecoder& operator=(const LzDecoder& d) noexcept = default;
+
+	/**
+	 * Start a new stream, coded with dict
+	 * @param  {CompressionDictionary*} dict : nullptr for none
+	 */
+	void reset(const CompressionDictionary* const dict = nullptr) noexcept;
+
+	/**
+	 * Decode from in into out until in is used up or out is full. Returns
+	 * the number of bytes written to out and sets consumed to the number
+	 * of bytes of in used; call again with the rest of in, or more of it,
+	 * to continue. Stops early if a match refers back past the start of
+	 * the stream; see isError.
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} len       : 
+	 * @param  {size_t*} consumed : 
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} capacity  : 
+	 * @return {size_t}           : bytes written to out
+	 */
+	size_t decode(
+		const uint8_t* const in,
+		const size_t len,
+		size_t* const consumed,
+		uint8_t* const out,
+		const size_t capacity) noexcept;
+
+	/**
+	 * Whether the stream is corrupt; nothing more is decoded until reset
+	 * @return {bool}  :
+	 */
+	bool isError() const noexcept;
+
+};
+};
+
+#endif
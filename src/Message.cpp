@@ -21,6 +21,8 @@
 // SOFTWARE.
 
 #include "Message.h"
+#include "Allocator.h"
+#include "MessageView.h"
 #include "Util.h"
 
 /**
@@ -31,7 +33,6 @@
  * 	BODY	| 0x4 - {BODY LEN - 1}	[ BODY DATA ]
  */
 namespace RadioPacket {
-class Message {
 
 void Message::_init() {
 	this->_data.clear();
@@ -39,16 +40,20 @@ void Message::_init() {
 	this->_data.copyFrom(Message::_DEFAULT_HEADER_DATA, Message::getHeaderLength());
 }
 
-constexpr uint16_t Message::getMaxMessageLength() {
-	return 0xffff;
-}
+bool Message::_copyFrom(const MessageView& v) noexcept {
 
-constexpr uint16_t Message::getHeaderLength() {
-	return Message::_HEADER_LEN;
-}
+	//header and body are contiguous, so copy both at once
+	this->_data.resize(v.getMessageLength(), false);
+
+	//length is left unchanged if the data could not be allocated
+	if(this->_data.length() != v.getMessageLength()) {
+		return false;
+	}
+
+	this->_data.copyFrom(v.getData(), v.getMessageLength());
+
+	return true;
 
-constexpr uint16_t Message::getMaxBodyLength() {
-	return Message::getMaxMessageLength() - Message::getHeaderLength();
 }
 
 Message::Message() noexcept {
@@ -60,8 +65,22 @@ Message::Message(const uint8_t* const data, const uint16_t len) noexcept
 		this->setBodyData(data, len);
 }
 
-Message::Message(const Message& m) noexcept {
+Message::Message(const Message& m) noexcept
+	: _data(m._data) {
+}
+
+Message::Message(Message&& m) noexcept
+	: _data(Util::move(m._data)) {
+}
+
+Message& Message::operator=(const Message& m) noexcept {
 	this->_data = m._data;
+	return *this;
+}
+
+Message& Message::operator=(Message&& m) noexcept {
+	this->_data = Util::move(m._data);
+	return *this;
 }
 
 uint16_t Message::getRawBodyLength() const noexcept {
@@ -112,7 +131,7 @@ void Message::resizeBody(const uint16_t bodyLen, const bool copy) noexcept {
 	//must store a copy of the header before resizing the body
 	//, then copy it back in
 	if(!copy) {
-		uint8_t headerCopy[Message::getHeaderLength()];
+		uint8_t headerCopy[Message::getHeaderLength()] = {};
 		this->_data.copyTo(headerCopy, Message::getHeaderLength());
 		this->_data.resize(Message::getHeaderLength() + bodyLen, false);
 		this->_data.copyFrom(headerCopy, Message::getHeaderLength());
@@ -121,6 +140,11 @@ void Message::resizeBody(const uint16_t bodyLen, const bool copy) noexcept {
 		this->_data.resize(Message::getHeaderLength() + bodyLen, true);
 	}
 
+	//leave the body length as it was if the array could not be resized
+	if(this->_data.length() != Message::getHeaderLength() + bodyLen) {
+		return;
+	}
+
 	this->setRawBodyLength(bodyLen);
 
 }
@@ -139,33 +163,77 @@ const uint8_t* Message::getBodyData() const noexcept {
 
 uint8_t Message::parse(Message** const m, const uint8_t* const buff, const uint16_t len) noexcept {
 
-	if(len < Message::getHeaderLength()) {
-		return Message::PARSE_ERROR_INSUFFICIENT_HEADER_BYTES;
+	//validate in place before allocating anything
+	MessageView v;
+	const uint8_t result = MessageView::parse(&v, buff, len);
+
+	if(result != Message::PARSE_OK) {
+		return result;
 	}
 
 	*m = new Message;
 
-	(*m)->_data.copyFrom(buff, Message::getHeaderLength());
-
-	//insufficient bytes
-	if((*m)->getRawBodyLength() < (len - Message::getHeaderLength())) {
-		delete *m;
-		return Message::PARSE_ERROR_INSUFFICIENT_BUFFER_BYTES;
+	if(*m == nullptr) {
+		return Message::PARSE_ERROR_OUT_OF_MEMORY;
 	}
 
-	//too many bytes
-	if((*m)->getRawBodyLength() > Message::getMaxBodyLength()) {
+	if(!(*m)->_copyFrom(v)) {
 		delete *m;
-		return Message::PARSE_ERROR_BODY_LENGTH_EXCEEDED;
+		*m = nullptr;
+		return Message::PARSE_ERROR_OUT_OF_MEMORY;
 	}
 
-	(*m)->setBodyData(buff + Message::getHeaderLength(), (*m)->getRawBodyLength());
-
 	return Message::PARSE_OK;
 
 }
 
-};
+uint8_t Message::parse(
+	PoolHandle<Message>* const m,
+	Pool<Message>& pool,
+	const uint8_t* const buff,
+	const uint16_t len) noexcept {
+
+		//validate in place before drawing from the pool
+		MessageView v;
+		const uint8_t result = MessageView::parse(&v, buff, len);
+
+		if(result != Message::PARSE_OK) {
+			return result;
+		}
+
+		//reuse any message already held by the handle; its buffer is
+		//kept, so steady-state parsing does not allocate
+		if(!*m) {
+			*m = pool.acquire();
+		}
+
+		if(!*m) {
+			return Message::PARSE_ERROR_POOL_EXHAUSTED;
+		}
+
+		if(!(*m)->_copyFrom(v)) {
+			m->reset();
+			return Message::PARSE_ERROR_OUT_OF_MEMORY;
+		}
+
+		return Message::PARSE_OK;
+
+}
+
+void* Message::operator new(const size_t size) noexcept {
+	return RADIOPACKET_ALLOCATOR(Message)::allocate(size);
+}
+
+void* Message::operator new(const size_t, void* const ptr) noexcept {
+	return ptr;
+}
+
+void Message::operator delete(void* const ptr, const size_t size) noexcept {
+	RADIOPACKET_ALLOCATOR(Message)::deallocate(ptr, size);
+}
+
+void Message::operator delete(void* const, void* const) noexcept {
+}
 
 constexpr uint8_t Message::_DEFAULT_HEADER_DATA[];
 
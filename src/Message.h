@@ -23,9 +23,27 @@
 #ifndef MESSAGE_H_E85F6136_F60E_476D_95CA_8461D274B8A7
 #define MESSAGE_H_E85F6136_F60E_476D_95CA_8461D274B8A7
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "NetworkBuffer.h"
+#include "ObjectPool.h"
+
+/**
+ * Define RADIOPACKET_MESSAGE_CAPACITY (in bytes, including the header) to
+ * hold Message data inline in a fixed-size buffer instead of on the heap.
+ * getMaxMessageLength() then returns the capacity rather than 0xffff.
+ *
+ * Otherwise Message data, and Messages created with new, are allocated
+ * through RADIOPACKET_ALLOCATOR(Message); see Allocator.h.
+ */
+#ifdef RADIOPACKET_MESSAGE_CAPACITY
+	#define RADIOPACKET_MESSAGE_STORAGE InlineStorage<RADIOPACKET_MESSAGE_CAPACITY>
+	#define RADIOPACKET_MESSAGE_MAX_LENGTH RADIOPACKET_MESSAGE_CAPACITY
+#else
+	#define RADIOPACKET_MESSAGE_STORAGE AllocatedStorage<RADIOPACKET_ALLOCATOR(Message)>
+	#define RADIOPACKET_MESSAGE_MAX_LENGTH 0xffff
+#endif
 
 /**
  * Message format:
@@ -35,10 +53,20 @@
  * 	BODY	| 0x4 - {BODY LEN - 1}	[ BODY DATA ]
  */
 namespace RadioPacket {
+
+class Compression;
+class MessageAggregator;
+class MessageView;
+class PacketEncoder;
+
+template<uint16_t Action, class... Fields>
+class MessageSchema;
+
 class Message {
 
 protected:
 
+	static const uint16_t _MAX_MESSAGE_LEN = RADIOPACKET_MESSAGE_MAX_LENGTH;
 	static const uint16_t _HEADER_LEN = 4;
 	static const uint8_t _BODYLEN_OFFSET = 0x0;
 	static const uint8_t _ACTION_OFFSET = 0x2;
@@ -48,9 +76,26 @@ protected:
 		/* 0x2 - 0x3 */ 0x0, 0x0  /* action, 2 bytes, unsigned */
 	};
 
+	static_assert(_MAX_MESSAGE_LEN >= _HEADER_LEN,
+		"RADIOPACKET_MESSAGE_CAPACITY must be able to hold a Message header");
+
 	void _init();
 
-	NetworkBuffer<uint8_t, uint16_t> _data;
+	/**
+	 * Copy an already-validated message's header and body into this message
+	 * Returns false if the message's data could not be allocated
+	 */
+	bool _copyFrom(const MessageView& v) noexcept;
+
+	NetworkBuffer<uint8_t, uint16_t, RADIOPACKET_MESSAGE_STORAGE> _data;
+
+	friend class Compression;
+	friend class MessageAggregator;
+	friend class MessageView;
+	friend class PacketEncoder;
+
+	template<uint16_t Action, class... Fields>
+	friend class MessageSchema;
 
 
 public:
@@ -60,16 +105,39 @@ public:
 	static const uint8_t PARSE_ERROR_INSUFFICIENT_BUFFER_BYTES = 2;
 	static const uint8_t PARSE_ERROR_BODY_LENGTH_EXCEEDED = 3;
 	static const uint8_t BODY_LENGTH_EXCEEDED = 4;
+	static const uint8_t PARSE_ERROR_POOL_EXHAUSTED = 5;
+	static const uint8_t PARSE_ERROR_OUT_OF_MEMORY = 6;
+
+	static constexpr uint16_t getMaxMessageLength() noexcept {
+		return _MAX_MESSAGE_LEN;
+	}
 
-	static constexpr uint16_t getMaxMessageLength();
-	static constexpr uint16_t getHeaderLength();
-	static constexpr uint16_t getMaxBodyLength();
+	static constexpr uint16_t getHeaderLength() noexcept {
+		return _HEADER_LEN;
+	}
+
+	static constexpr uint16_t getMaxBodyLength() noexcept {
+		return getMaxMessageLength() - getHeaderLength();
+	}
 
 	Message() noexcept;
 	Message(const uint8_t* const data, const uint16_t len) noexcept;
 	Message(const Message& m) noexcept;
+	Message(Message&& m) noexcept;
+	Message& operator=(const Message& m) noexcept;
+	Message& operator=(Message&& m) noexcept;
 	virtual ~Message() = default;
 
+	/**
+	 * Messages created with new are allocated through
+	 * RADIOPACKET_ALLOCATOR(Message), and new yields nullptr rather than
+	 * throwing if the allocator fails
+	 */
+	static void* operator new(const size_t size) noexcept;
+	static void* operator new(const size_t size, void* const ptr) noexcept;
+	static void operator delete(void* const ptr, const size_t size) noexcept;
+	static void operator delete(void* const ptr, void* const) noexcept;
+
 	uint16_t getRawBodyLength() const noexcept;
 	uint16_t getRawAction() const noexcept;
 	void setRawBodyLength(const uint16_t len) noexcept;
@@ -85,6 +153,20 @@ public:
 	const uint8_t* getBodyData() const noexcept;
 	static uint8_t parse(Message** const m, const uint8_t* const buff, const uint16_t len) noexcept;
 
+	/**
+	 * Parse arbitrary bytes into a message drawn from pool. Nothing is
+	 * allocated for the Message object itself; it is returned to pool when
+	 * m is reset or destroyed. A message already held by m is reused along
+	 * with its buffer, so parsing repeatedly into the same handle does not
+	 * allocate once the buffer is large enough. Returns Message::PARSE_OK
+	 * on success.
+	 */
+	static uint8_t parse(
+		PoolHandle<Message>* const m,
+		Pool<Message>& pool,
+		const uint8_t* const buff,
+		const uint16_t len) noexcept;
+
 };
 };
 
@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "MessageAggregate.h"
+
+#include <string.h>
+#include "Crc.h"
+#include "Util.h"
+
+namespace RadioPacket {
+
+MessageAggregator::MessageAggregator(uint8_t* const buff) noexcept
+	: _buff(buff) {
+		this->_encoder.setRawFragmentNumber(MessageAggregator::FRAGMENT_NUMBER);
+}
+
+void MessageAggregator::setRawVersion(const uint8_t version) noexcept {
+	this->_encoder.setRawVersion(version);
+	this->_encoder.setRawFragmentNumber(MessageAggregator::FRAGMENT_NUMBER);
+	this->reset();
+}
+
+bool MessageAggregator::setRawTransmitterId(const uint16_t id) noexcept {
+	return this->_encoder.setRawTransmitterId(id);
+}
+
+bool MessageAggregator::setRawReceiverId(const uint16_t id) noexcept {
+	return this->_encoder.setRawReceiverId(id);
+}
+
+void MessageAggregator::setRawSequenceNumber(const uint16_t n) noexcept {
+	this->_encoder.setRawSequenceNumber(n);
+}
+
+bool MessageAggregator::add(
+	const uint16_t action,
+	const uint8_t* const payload,
+	const uint8_t len) noexcept {
+
+		//compare the whole Message, as the remaining payload length is 0
+		//both when a header just fits and when it does not
+		if(this->_messageCount == 0xff ||
+			Message::getHeaderLength() + len > this->_encoder.getMaxBodyLength() - this->_bodyLength) {
+				return false;
+		}
+
+		uint8_t* const msg = this->_buff + this->_encoder.getFormat()->headerLength + this->_bodyLength;
+		const uint16_t netLen = (Util::htons)(len);
+		const uint16_t netAction = (Util::htons)(action);
+
+		::memcpy(&msg[Message::_BODYLEN_OFFSET], &netLen, sizeof(uint16_t));
+		::memcpy(&msg[Message::_ACTION_OFFSET], &netAction, sizeof(uint16_t));
+
+		if(len > 0) {
+			::memcpy(msg + Message::getHeaderLength(), payload, len);
+		}
+
+		this->_bodyLength += Message::getHeaderLength() + len;
+		++this->_messageCount;
+
+		return true;
+
+}
+
+bool MessageAggregator::add(const Message* const m) noexcept {
+
+	const uint16_t len = m->getMessageLength();
+
+	if(this->_messageCount == 0xff ||
+		len > this->_encoder.getMaxBodyLength() - this->_bodyLength) {
+			return false;
+	}
+
+	//the Message's header is already in network byte order
+	::memcpy(
+		this->_buff + this->_encoder.getFormat()->headerLength + this->_bodyLength,
+		m->getData(),
+		len);
+
+	this->_bodyLength += static_cast<uint8_t>(len);
+	++this->_messageCount;
+
+	return true;
+
+}
+
+uint8_t MessageAggregator::getRemainingPayloadLength() const noexcept {
+
+	const uint8_t remaining = this->_encoder.getMaxBodyLength() - this->_bodyLength;
+
+	return remaining > Message::getHeaderLength()
+		? remaining - Message::getHeaderLength()
+		: 0;
+
+}
+
+uint8_t MessageAggregator::getMessageCount() const noexcept {
+	return this->_messageCount;
+}
+
+uint8_t MessageAggregator::finish() noexcept {
+
+	if(this->_messageCount == 0) {
+		return 0;
+	}
+
+	const PacketFormat* const format = this->_encoder.getFormat();
+
+	//the Messages are already in place after the header
+	uint8_t crc = this->_encoder._writeHeader(this->_buff, this->_bodyLength);
+	crc = Crc8Ccitt::update(crc, this->_buff + format->headerLength, this->_bodyLength);
+	this->_buff[format->crc8Offset] = Crc8Ccitt::finalize(crc);
+
+	const uint8_t len = format->headerLength + this->_bodyLength;
+
+	this->reset();
+
+	return len;
+
+}
+
+void MessageAggregator::reset() noexcept {
+	this->_bodyLength = 0;
+	this->_messageCount = 0;
+}
+
+bool AggregateIterator::isAggregate(const RadioPacketView& p) noexcept {
+	return p.isValid() && p.getRawFragmentNumber() == MessageAggregator::FRAGMENT_NUMBER;
+}
+
+AggregateIterator::AggregateIterator(const RadioPacketView& p) noexcept
+	: AggregateIterator(
+		p.isValid() ? p.getBodyData() : nullptr,
+		p.isValid() ? p.getRawBodyLength() : 0) {
+}
+
+AggregateIterator::AggregateIterator(const uint8_t* const body, const uint8_t len) noexcept
+	: _data(body), _length(body != nullptr ? len : 0) {
+}
+
+bool AggregateIterator::next(MessageView* const m) noexcept {
+
+	if(this->_malformed || this->_offset >= this->_length) {
+		return false;
+	}
+
+	if(MessageView::parse(
+		m,
+		this->_data + this->_offset,
+		this->_length - this->_offset) != Message::PARSE_OK) {
+			this->_malformed = true;
+			return false;
+	}
+
+	this->_offset += static_cast<uint8_t>(m->getMessageLength());
+
+	return true;
+
+}
+
+bool AggregateIterator::isMalformed() const noexcept {
+	return this->_malformed;
+}
+
+void AggregateIterator::rewind() noexcept {
+	this->_offset = 0;
+	this->_malformed = false;
+}
+
+};
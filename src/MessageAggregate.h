@@ -0,0 +1,221 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MESSAGE_AGGREGATE_H_10588528_95E9_4957_B9C6_03A857417ADB
+#define MESSAGE_AGGREGATE_H_10588528_95E9_4957_B9C6_03A857417ADB
+
+#include <stdint.h>
+
+#include "Message.h"
+#include "MessageView.h"
+#include "PacketEncoder.h"
+#include "RadioPacket.h"
+#include "RadioPacketView.h"
+
+/**
+ * An aggregate packet carries several Messages back to back in its body,
+ * rather than one, so small messages share a single header, CRC and
+ * transmission. Each Message keeps its own header, whose body length
+ * marks where the next begins:
+ *
+ * 	BODY	| [ MESSAGE HEADER ][ MESSAGE BODY ][ MESSAGE HEADER ] ...
+ *
+ * Fragments are numbered from 1, so an aggregate packet is marked by a
+ * fragment number of 0 (MessageAggregator::FRAGMENT_NUMBER). Messages too
+ * large for one packet are still sent with a Fragmenter.
+ */
+namespace RadioPacket {
+
+/**
+ * Builds an aggregate packet in a caller's buffer of at least
+ * RadioPacket::getMaxPacketLength() bytes. Each Message is written
+ * straight into place as it is added; finish() then writes the packet
+ * header and CRC around them.
+ *
+ * 	uint8_t buff[RadioPacket::getMaxPacketLength()];
+ * 	MessageAggregator a(buff);
+ *
+ * 	if(!a.add(STATUS, status, sizeof(status))) {
+ * 		man.transmitArray(a.finish(), buff);
+ * 		a.add(STATUS, status, sizeof(status));
+ * 	}
+ */
+class MessageAggregator {
+
+protected:
+
+	uint8_t* _buff;
+
+	/**
+	 * Holds the packet header
+	 */
+	PacketEncoder _encoder;
+
+	uint8_t _bodyLength = 0;
+	uint8_t _messageCount = 0;
+
+
+public:
+
+	static const uint8_t FRAGMENT_NUMBER = 0;
+
+	/**
+	 * @param  {uint8_t*} const : buffer the packet is built in
+	 */
+	MessageAggregator(uint8_t* const buff) noexcept;
+
+	MessageAggregator(const MessageAggregator& a) = delete;
+	MessageAggregator& operator=(const MessageAggregator& a) = delete;
+
+	/**
+	 * Set the version of the packet header. As this moves the body, any
+	 * Messages already added are discarded; call it before adding any.
+	 * @param  {uint8_t} version :
+	 */
+	void setRawVersion(const uint8_t version) noexcept;
+
+	/**
+	 * See PacketEncoder::setRawTransmitterId
+	 */
+	bool setRawTransmitterId(const uint16_t id) noexcept;
+	bool setRawReceiverId(const uint16_t id) noexcept;
+
+	/**
+	 * See PacketEncoder::setRawSequenceNumber
+	 * @param  {uint16_t} n :
+	 */
+	void setRawSequenceNumber(const uint16_t n) noexcept;
+
+	/**
+	 * Append a Message with the given action and len bytes of payload.
+	 * Returns false, leaving the packet as it was, if it does not fit.
+	 * @param  {uint16_t} action :
+	 * @param  {uint8_t*} const  :
+	 * @param  {uint8_t} len     :
+	 * @return {bool}            :
+	 */
+	bool add(
+		const uint16_t action,
+		const uint8_t* const payload,
+		const uint8_t len) noexcept;
+
+	/**
+	 * Append a copy of a Message
+	 * @param  {Message*} m :
+	 * @return {bool}       :
+	 */
+	bool add(const Message* const m) noexcept;
+
+	/**
+	 * Largest payload the next Message added can carry; 0 both when only
+	 * an empty Message fits and when not even that does
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getRemainingPayloadLength() const noexcept;
+
+	uint8_t getMessageCount() const noexcept;
+
+	/**
+	 * Write the packet header and CRC around the Messages added and
+	 * return the packet's length, or 0 if there are none. The aggregator
+	 * is then empty, ready to build the next packet in the same buffer
+	 * once this one has been transmitted.
+	 * @return {uint8_t}  : packet length
+	 */
+	uint8_t finish() noexcept;
+
+	/**
+	 * Discard the Messages added so far
+	 */
+	void reset() noexcept;
+
+};
+
+/**
+ * Walks the Messages in an aggregate packet's body in place, yielding a
+ * MessageView of each. Nothing is copied; the body must outlive the views.
+ *
+ * 	AggregateIterator it(view);
+ * 	MessageView m;
+ *
+ * 	while(it.next(&m)) {
+ * 		//use m
+ * 	}
+ *
+ * 	if(it.isMalformed()) {
+ * 		//the last Message ran past the end of the body
+ * 	}
+ */
+class AggregateIterator {
+
+protected:
+
+	const uint8_t* _data;
+	uint8_t _length;
+	uint8_t _offset = 0;
+	bool _malformed = false;
+
+
+public:
+
+	/**
+	 * Whether a packet is an aggregate
+	 * @param  {RadioPacketView} p :
+	 * @return {bool}              :
+	 */
+	static bool isAggregate(const RadioPacketView& p) noexcept;
+
+	/**
+	 * @param  {RadioPacketView} p : parsed aggregate packet
+	 */
+	AggregateIterator(const RadioPacketView& p) noexcept;
+
+	/**
+	 * @param  {uint8_t*} const : aggregate packet body
+	 * @param  {uint8_t} len    :
+	 */
+	AggregateIterator(const uint8_t* const body, const uint8_t len) noexcept;
+
+	/**
+	 * Point m at the next Message and return true, or return false once
+	 * the body is used up or the next Message is malformed
+	 * @param  {MessageView*} const :
+	 * @return {bool}               :
+	 */
+	bool next(MessageView* const m) noexcept;
+
+	/**
+	 * Whether iteration stopped at bytes which are not a whole Message
+	 * @return {bool}  :
+	 */
+	bool isMalformed() const noexcept;
+
+	/**
+	 * Start again from the first Message
+	 */
+	void rewind() noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,323 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef MESSAGE_SCHEMA_H_6B8D0771_ACD2_48B4_B919_6AE8F4111F41
+#define MESSAGE_SCHEMA_H_6B8D0771_ACD2_48B4_B919_6AE8F4111F41
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Compression.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "Meta.h"
+#include "PacketEncoder.h"
+#include "PacketLayout.h"
+#include "RadioPacket.h"
+#include "Util.h"
+
+/**
+ * Compile-time Message layouts.
+ *
+ * A MessageSchema declares a Message's action and the fields of its body,
+ * in order. Each field's offset is resolved at compile time, and fields
+ * are read and written directly, in network byte order, with no runtime
+ * bounds checks. The same accessors work on an owning Message, on a
+ * MessageView and on a raw body buffer (eg. one later passed to a
+ * PacketEncoder).
+ *
+ * 	typedef MessageSchema<
+ * 		1,							//action
+ * 		Field<uint16_t>,			//0: battery voltage
+ * 		ArrayField<int16_t, 3>		//1: acceleration x, y, z
+ * 	> MotionMessage;
+ *
+ * 	Message m;
+ * 	if(MotionMessage::init(m)) {
+ * 		MotionMessage::set<0>(m, 3300);
+ * 		MotionMessage::set<1>(m, -12, 2);
+ * 	}
+ *
+ * 	if(MotionMessage::matches(view)) {
+ * 		const int16_t z = MotionMessage::get<1>(view, 2);
+ * 	}
+ *
+ * A schema's body must fit in a single RadioPacket of any known version,
+ * so that encode() succeeds whatever the encoder's header.
+ */
+namespace RadioPacket {
+
+/**
+ * A single value of type T
+ */
+template<class T>
+struct Field {
+	typedef T Type;
+	static const uint16_t COUNT = 1;
+	static const uint16_t SIZE = sizeof(T);
+};
+
+/**
+ * A fixed-length array of N values of type T
+ */
+template<class T, uint16_t N>
+struct ArrayField {
+	static_assert(N > 0, "ArrayField must hold at least one element");
+	typedef T Type;
+	static const uint16_t COUNT = N;
+	static const uint16_t SIZE = sizeof(T) * N;
+};
+
+/**
+ * Unsigned integer of the given size and its byte order conversion
+ */
+template<size_t Size>
+struct SchemaBytes;
+
+template<>
+struct SchemaBytes<1> {
+	typedef uint8_t Type;
+	static inline Type swap(const Type v) noexcept { return v; }
+};
+
+template<>
+struct SchemaBytes<2> {
+	typedef uint16_t Type;
+	static inline Type swap(const Type v) noexcept { return (Util::ntohs)(v); }
+};
+
+template<>
+struct SchemaBytes<4> {
+	typedef uint32_t Type;
+	static inline Type swap(const Type v) noexcept { return (Util::ntohl)(v); }
+};
+
+template<>
+struct SchemaBytes<8> {
+	typedef uint64_t Type;
+	static inline Type swap(const Type v) noexcept { return (Util::ntohll)(v); }
+};
+
+/**
+ * Combined size of Fields
+ */
+template<class... Fields>
+struct SchemaSize;
+
+template<>
+struct SchemaSize<> {
+	static const uint16_t VALUE = 0;
+};
+
+template<class F, class... Fs>
+struct SchemaSize<F, Fs...> {
+	static const uint16_t VALUE = F::SIZE + SchemaSize<Fs...>::VALUE;
+};
+
+/**
+ * Offset of the Ith of Fields
+ */
+template<size_t I, class... Fields>
+struct SchemaOffset;
+
+template<class F, class... Fs>
+struct SchemaOffset<0, F, Fs...> {
+	static const uint16_t VALUE = 0;
+};
+
+template<size_t I, class F, class... Fs>
+struct SchemaOffset<I, F, Fs...> {
+	static const uint16_t VALUE = F::SIZE + SchemaOffset<I - 1, Fs...>::VALUE;
+};
+
+template<uint16_t Action, class... Fields>
+class MessageSchema {
+
+	static_assert(sizeof...(Fields) > 0, "MessageSchema must have at least one field");
+	static_assert(Action < Compression::ACTION_FLAG,
+		"MessageSchema action is reserved for compressed Messages");
+	static_assert(SchemaSize<Fields...>::VALUE <= Message::getMaxBodyLength(),
+		"MessageSchema body exceeds the maximum Message body length");
+	static_assert(Message::getHeaderLength() + SchemaSize<Fields...>::VALUE <=
+		RadioPacket::getMaxPacketLength() - KnownPacketLayouts::getMaxHeaderLength(),
+		"MessageSchema must fit in a single RadioPacket of any version");
+
+protected:
+
+	template<class T>
+	static inline T _read(const uint8_t* const p) noexcept {
+		typename SchemaBytes<sizeof(T)>::Type u;
+		T v;
+		::memcpy(&u, p, sizeof(T));
+		u = SchemaBytes<sizeof(T)>::swap(u);
+		::memcpy(&v, &u, sizeof(T));
+		return v;
+	}
+
+	template<class T>
+	static inline void _write(uint8_t* const p, const T v) noexcept {
+		typename SchemaBytes<sizeof(T)>::Type u;
+		::memcpy(&u, &v, sizeof(T));
+		u = SchemaBytes<sizeof(T)>::swap(u);
+		::memcpy(p, &u, sizeof(T));
+	}
+
+	static inline uint8_t* _bodyOf(Message& m) noexcept {
+		return &m._data[Message::getHeaderLength()];
+	}
+
+
+public:
+
+	static const uint16_t ACTION = Action;
+
+	/**
+	 * The Ith field's declaration, element type and offset in the body
+	 */
+	template<size_t I>
+	struct FieldAt {
+		static_assert(I < sizeof...(Fields), "MessageSchema has no such field");
+		typedef typename Meta::TypeAt<I, Fields...>::Type Declaration;
+		typedef typename Declaration::Type Type;
+		static const uint16_t OFFSET = SchemaOffset<I, Fields...>::VALUE;
+	};
+
+	/**
+	 * Length of the Message body
+	 * @return {uint16_t}  :
+	 */
+	static constexpr uint16_t getBodyLength() noexcept {
+		return SchemaSize<Fields...>::VALUE;
+	}
+
+	/**
+	 * Offset of field I in the Message body
+	 * @return {uint16_t}  :
+	 */
+	template<size_t I>
+	static constexpr uint16_t getOffset() noexcept {
+		return FieldAt<I>::OFFSET;
+	}
+
+	/**
+	 * Read element index of field I from a Message body
+	 * index must be less than the field's element count
+	 * @param  {uint8_t*} const : Message body
+	 * @param  {uint16_t} index :
+	 * @return {Type}           :
+	 */
+	template<size_t I>
+	static typename FieldAt<I>::Type get(const uint8_t* const body, const uint16_t index = 0) noexcept {
+		typedef typename FieldAt<I>::Type T;
+		return _read<T>(body + FieldAt<I>::OFFSET + index * sizeof(T));
+	}
+
+	template<size_t I>
+	static typename FieldAt<I>::Type get(const MessageView& m, const uint16_t index = 0) noexcept {
+		return get<I>(m.getBodyData(), index);
+	}
+
+	template<size_t I>
+	static typename FieldAt<I>::Type get(const Message& m, const uint16_t index = 0) noexcept {
+		return get<I>(m.getBodyData(), index);
+	}
+
+	/**
+	 * Write element index of field I into a Message body
+	 * index must be less than the field's element count
+	 * @param  {uint8_t*} const : Message body
+	 * @param  {Type} v         :
+	 * @param  {uint16_t} index :
+	 */
+	template<size_t I>
+	static void set(uint8_t* const body, const typename FieldAt<I>::Type v, const uint16_t index = 0) noexcept {
+		typedef typename FieldAt<I>::Type T;
+		_write<T>(body + FieldAt<I>::OFFSET + index * sizeof(T), v);
+	}
+
+	/**
+	 * m must have been initialised by a successful init
+	 */
+	template<size_t I>
+	static void set(Message& m, const typename FieldAt<I>::Type v, const uint16_t index = 0) noexcept {
+		set<I>(_bodyOf(m), v, index);
+	}
+
+	/**
+	 * Set m's action and size its body for this schema, zeroing every
+	 * field. Returns false, leaving the fields unset, if the body could
+	 * not be resized.
+	 * @param  {Message&} m :
+	 * @return {bool}       :
+	 */
+	static bool init(Message& m) noexcept {
+
+		m.setRawAction(Action);
+		m.resizeBody(getBodyLength(), false);
+
+		if(m.getRawBodyLength() != getBodyLength()) {
+			return false;
+		}
+
+		Util::zero(_bodyOf(m), getBodyLength());
+
+		return true;
+
+	}
+
+	/**
+	 * Whether m has this schema's action and a body long enough to hold
+	 * its fields. Longer bodies match, so fields can be appended to a
+	 * schema without breaking older receivers.
+	 * @param  {MessageView} m :
+	 * @return {bool}          :
+	 */
+	static bool matches(const MessageView& m) noexcept {
+		return m.getRawAction() == Action && m.getRawBodyLength() >= getBodyLength();
+	}
+
+	static bool matches(const Message& m) noexcept {
+		return m.getRawAction() == Action && m.getRawBodyLength() >= getBodyLength();
+	}
+
+	/**
+	 * Encode a packet holding a Message with this schema's action and
+	 * body into buff; see PacketEncoder::encodeMessage
+	 * @param  {PacketEncoder&} e :
+	 * @param  {uint8_t*} const   : destination buffer
+	 * @param  {uint8_t*} const   : Message body, getBodyLength() bytes
+	 * @return {uint8_t}          : packet length
+	 */
+	static uint8_t encode(PacketEncoder& e, uint8_t* const buff, const uint8_t* const body) noexcept {
+		return e.encodeMessage(buff, Action, body, getBodyLength());
+	}
+
+};
+
+template<uint16_t Action, class... Fields>
+const uint16_t MessageSchema<Action, Fields...>::ACTION;
+
+};
+
+#endif
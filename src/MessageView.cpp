@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "MessageView.h"
+
+#include <string.h>
+#include "Util.h"
+
+namespace RadioPacket {
+
+MessageView::MessageView() noexcept {
+}
+
+bool MessageView::isValid() const noexcept {
+	return this->_data != nullptr;
+}
+
+uint16_t MessageView::getRawBodyLength() const noexcept {
+	uint16_t netuint;
+	::memcpy(&netuint, &this->_data[Message::_BODYLEN_OFFSET], sizeof(uint16_t));
+	return (Util::ntohs)(netuint);
+}
+
+uint16_t MessageView::getRawAction() const noexcept {
+	uint16_t netuint;
+	::memcpy(&netuint, &this->_data[Message::_ACTION_OFFSET], sizeof(uint16_t));
+	return (Util::ntohs)(netuint);
+}
+
+uint16_t MessageView::fromBaseBodyOffset(const uint16_t offset) const noexcept {
+	return Message::getHeaderLength() + offset;
+}
+
+uint16_t MessageView::getMessageLength() const noexcept {
+	return Message::getHeaderLength() + this->getRawBodyLength();
+}
+
+const uint8_t* MessageView::getData() const noexcept {
+	return this->_data;
+}
+
+const uint8_t* MessageView::getHeaderData() const noexcept {
+	return this->_data;
+}
+
+const uint8_t* MessageView::getBodyData() const noexcept {
+	return this->_data + Message::getHeaderLength();
+}
+
+uint8_t MessageView::parse(MessageView* const m, const uint8_t* const buff, const uint16_t len) noexcept {
+
+	if(len < Message::getHeaderLength()) {
+		return Message::PARSE_ERROR_INSUFFICIENT_HEADER_BYTES;
+	}
+
+	uint16_t bodyLen;
+	::memcpy(&bodyLen, &buff[Message::_BODYLEN_OFFSET], sizeof(uint16_t));
+	bodyLen = (Util::ntohs)(bodyLen);
+
+	//insufficient bytes
+	if(bodyLen > (len - Message::getHeaderLength())) {
+		return Message::PARSE_ERROR_INSUFFICIENT_BUFFER_BYTES;
+	}
+
+	//too many bytes
+	if(bodyLen > Message::getMaxBodyLength()) {
+		return Message::PARSE_ERROR_BODY_LENGTH_EXCEEDED;
+	}
+
+	m->_data = buff;
+
+	return Message::PARSE_OK;
+
+}
+
+};
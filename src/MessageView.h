@@ -0,0 +1,85 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef MESSAGE_VIEW_H_4F86AC3C_85FD_4DAD_9902_666215936D15
+#define MESSAGE_VIEW_H_4F86AC3C_85FD_4DAD_9902_666215936D15
+
+#include <stdint.h>
+
+#include "Message.h"
+
+/**
+ * A MessageView is a non-owning, read-only window over a Message
+ * held in a caller's buffer, most commonly the body of a
+ * RadioPacketView.
+ *
+ * Nothing is allocated or copied; the buffer must outlive the view.
+ *
+ * The format is the same as Message.
+ */
+namespace RadioPacket {
+class MessageView {
+
+protected:
+
+	const uint8_t* _data = nullptr;
+
+
+public:
+
+	MessageView() noexcept;
+	MessageView(const MessageView& v) noexcept = default;
+	MessageView& operator=(const MessageView& v) noexcept = default;
+
+	/**
+	 * Whether this view refers to a parsed message
+	 * @return {bool}  :
+	 */
+	bool isValid() const noexcept;
+
+	uint16_t getRawBodyLength() const noexcept;
+	uint16_t getRawAction() const noexcept;
+	uint16_t fromBaseBodyOffset(const uint16_t offset = 0) const noexcept;
+	uint16_t getMessageLength() const noexcept;
+
+	const uint8_t* getData() const noexcept;
+	const uint8_t* getHeaderData() const noexcept;
+	const uint8_t* getBodyData() const noexcept;
+
+	/**
+	 * Validate arbitrary bytes as a message and point m at them. Returns
+	 * Message::PARSE_OK on success, in which case m remains valid for as
+	 * long as buff does.
+	 * @param  {MessageView*} const :
+	 * @param  {uint8_t*} const     : array of bytes
+	 * @param  {uint16_t} len       : length of byte array
+	 * @return {uint8_t}            : one of the Message::PARSE_* constants
+	 */
+	static uint8_t parse(
+		MessageView* const m,
+		const uint8_t* const buff,
+		const uint16_t len) noexcept;
+
+};
+};
+
+#endif
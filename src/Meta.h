@@ -0,0 +1,115 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef META_H_639C2EA5_3A4F_46DE_8FC3_6A36C246B765
+#define META_H_639C2EA5_3A4F_46DE_8FC3_6A36C246B765
+
+#include <stddef.h>
+
+/**
+ * Compile-time helpers.
+ *
+ * The AVR toolchain ships without the C++ standard library, so the small
+ * parts of <utility> and <type_traits> this library needs live here.
+ */
+namespace RadioPacket {
+namespace Meta {
+
+/**
+ * Equivalent to std::index_sequence
+ */
+template<size_t... I>
+struct IndexSequence {
+};
+
+template<size_t N, size_t... I>
+struct MakeIndexSequence : MakeIndexSequence<N - 1, N - 1, I...> {
+};
+
+template<size_t... I>
+struct MakeIndexSequence<0, I...> {
+	typedef IndexSequence<I...> Type;
+};
+
+/**
+ * Equivalent to std::conditional
+ */
+template<bool B, class T, class F>
+struct Conditional {
+	typedef T Type;
+};
+
+template<class T, class F>
+struct Conditional<false, T, F> {
+	typedef F Type;
+};
+
+/**
+ * Equivalent to std::make_unsigned, for the integer types
+ */
+template<class T>
+struct MakeUnsigned;
+
+template<> struct MakeUnsigned<signed char> { typedef unsigned char Type; };
+template<> struct MakeUnsigned<short> { typedef unsigned short Type; };
+template<> struct MakeUnsigned<int> { typedef unsigned int Type; };
+template<> struct MakeUnsigned<long> { typedef unsigned long Type; };
+template<> struct MakeUnsigned<long long> { typedef unsigned long long Type; };
+template<> struct MakeUnsigned<unsigned char> { typedef unsigned char Type; };
+template<> struct MakeUnsigned<unsigned short> { typedef unsigned short Type; };
+template<> struct MakeUnsigned<unsigned int> { typedef unsigned int Type; };
+template<> struct MakeUnsigned<unsigned long> { typedef unsigned long Type; };
+template<> struct MakeUnsigned<unsigned long long> { typedef unsigned long long Type; };
+
+/**
+ * Equivalent to std::make_signed, for the integer types
+ */
+template<class T>
+struct MakeSigned;
+
+template<> struct MakeSigned<signed char> { typedef signed char Type; };
+template<> struct MakeSigned<short> { typedef short Type; };
+template<> struct MakeSigned<int> { typedef int Type; };
+template<> struct MakeSigned<long> { typedef long Type; };
+template<> struct MakeSigned<long long> { typedef long long Type; };
+template<> struct MakeSigned<unsigned char> { typedef signed char Type; };
+template<> struct MakeSigned<unsigned short> { typedef short Type; };
+template<> struct MakeSigned<unsigned int> { typedef int Type; };
+template<> struct MakeSigned<unsigned long> { typedef long Type; };
+template<> struct MakeSigned<unsigned long long> { typedef long long Type; };
+
+/**
+ * The Ith type of Ts
+ */
+template<size_t I, class T, class... Ts>
+struct TypeAt : TypeAt<I - 1, Ts...> {
+};
+
+template<class T, class... Ts>
+struct TypeAt<0, T, Ts...> {
+	typedef T Type;
+};
+
+};
+};
+
+#endif
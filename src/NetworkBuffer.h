@@ -27,8 +27,8 @@
 #include "Util.h"
 
 namespace RadioPacket {
-template<class StorageType, class IndexType = size_t>
-class NetworkBuffer : public ExpandingArray<StorageType, IndexType> {
+template<class StorageType, class IndexType = size_t, class Storage = HeapStorage>
+class NetworkBuffer : public ExpandingArray<StorageType, IndexType, Storage> {
 
 public:
 
@@ -37,17 +37,17 @@ public:
 	}
 
 	void setUInt16(const uint16_t s, const IndexType offset) noexcept {
-		const uint16_t netShort = Util::htons(s);
+		const uint16_t netShort = (Util::htons)(s);
 		this->copyFromAt(&netShort, sizeof(uint16_t), offset);
 	}
 
 	void setUInt32(const uint32_t i, const IndexType offset) noexcept {
-		const uint32_t netInt = Util::htonl(i);
+		const uint32_t netInt = (Util::htonl)(i);
 		this->copyFromAt(&netInt, sizeof(uint32_t), offset);
 	}
 
 	void setUInt64(const uint64_t ll, const IndexType offset) noexcept {
-		const uint64_t netLong = Util::htonll(ll);
+		const uint64_t netLong = (Util::htonll)(ll);
 		this->copyFromAt(&netLong, sizeof(uint64_t), offset);
 	}
 
@@ -56,21 +56,159 @@ public:
 	}
 
 	uint16_t getUInt16(const IndexType offset) const noexcept {
-		uint16_t netuint;
+		uint16_t netuint = 0;
 		this->copyToAt(&netuint, sizeof(uint16_t), offset);
-		return Util::ntohs(netuint);
+		return (Util::ntohs)(netuint);
 	}
 
 	uint32_t getUInt32(const IndexType offset) const noexcept {
-		uint32_t netuint;
+		uint32_t netuint = 0;
 		this->copyToAt(&netuint, sizeof(uint32_t), offset);
-		return Util::ntohl(netuint);
+		return (Util::ntohl)(netuint);
 	}
 
 	uint64_t getUInt64(const IndexType offset) const noexcept {
-		uint64_t netuint;
+		uint64_t netuint = 0;
 		this->copyToAt(&netuint, sizeof(uint64_t), offset);
-		return Util::ntohll(netuint);
+		return (Util::ntohll)(netuint);
+	}
+
+	/**
+	 * Write v as an LEB128 varint at offset, appending if it runs past the
+	 * end. Returns the number of bytes written, 0 on failure.
+	 * @param  {T} v                : unsigned integer
+	 * @param  {IndexType} offset   : 
+	 * @return {IndexType}          : 
+	 */
+	template<class T>
+	IndexType setVarUInt(const T v, const IndexType offset) noexcept {
+
+		uint8_t bytes[(sizeof(T) * 8 + 6) / 7];
+		const uint8_t n = Util::encodeVarint(bytes, sizeof(bytes), v);
+		const IndexType oldLen = this->length();
+
+		if(offset > oldLen) {
+			return 0;
+		}
+
+		this->copyFromAt(bytes, n, offset);
+
+		//copyFromAt leaves the array alone if it cannot grow
+		if(offset + n > this->length()) {
+			return 0;
+		}
+
+		return n;
+
+	}
+
+	/**
+	 * Read an LEB128 varint from offset into v. Returns the number of bytes
+	 * read, 0 if it is truncated or does not fit in T.
+	 * @param  {T*} const           : 
+	 * @param  {IndexType} offset   : 
+	 * @return {IndexType}          : 
+	 */
+	template<class T>
+	IndexType getVarUInt(T* const v, const IndexType offset) const noexcept {
+
+		if(offset >= this->length()) {
+			return 0;
+		}
+
+		return Util::decodeVarint(
+			this->ptr(offset),
+			this->length() - offset,
+			v);
+
+	}
+
+	/**
+	 * Write a signed integer as a zigzag varint at offset
+	 * @param  {T} v                : signed integer
+	 * @param  {IndexType} offset   : 
+	 * @return {IndexType}          : bytes written, 0 on failure
+	 */
+	template<class T>
+	IndexType setVarInt(const T v, const IndexType offset) noexcept {
+		return this->setVarUInt(Util::zigzagEncode(v), offset);
+	}
+
+	/**
+	 * Read a zigzag varint from offset into v
+	 * @param  {T*} const           : 
+	 * @param  {IndexType} offset   : 
+	 * @return {IndexType}          : bytes read, 0 on failure
+	 */
+	template<class T>
+	IndexType getVarInt(T* const v, const IndexType offset) const noexcept {
+
+		typename Meta::MakeUnsigned<T>::Type u = 0;
+		const IndexType n = this->getVarUInt(&u, offset);
+
+		if(n > 0) {
+			*v = Util::zigzagDecode(u);
+		}
+
+		return n;
+
+	}
+
+	/**
+	 * Write the low width bits of v at bitOffset bits into the buffer,
+	 * most significant bit first. The buffer grows to hold them, with any
+	 * new bytes zeroed. Returns false if it cannot grow.
+	 * @param  {T} v                : 
+	 * @param  {size_t} bitOffset   : 
+	 * @param  {uint8_t} width      : 
+	 * @return {bool}               : 
+	 */
+	template<class T>
+	bool setBits(const T v, const size_t bitOffset, const uint8_t width) noexcept {
+
+		const size_t needed = (bitOffset + width + 7) / 8;
+		const IndexType oldLen = this->length();
+
+		if(needed > oldLen) {
+
+			this->resize(static_cast<IndexType>(needed), true);
+
+			if(this->length() != needed) {
+				return false;
+			}
+
+			Util::zero(this->ptr(oldLen), needed - oldLen);
+
+		}
+
+		Util::setBits(this->ptr(), bitOffset, width, v);
+
+		return true;
+
+	}
+
+	/**
+	 * Read width bits starting bitOffset bits into the buffer; bits past
+	 * the end read as 0
+	 * @param  {size_t} bitOffset   : 
+	 * @param  {uint8_t} width      : 
+	 * @return {T}                  : 
+	 */
+	template<class T = uint32_t>
+	T getBits(const size_t bitOffset, const uint8_t width) const noexcept {
+
+		const size_t available = static_cast<size_t>(this->length()) * 8;
+
+		if(bitOffset >= available) {
+			return 0;
+		}
+		else if(bitOffset + width > available) {
+			const uint8_t n = static_cast<uint8_t>(available - bitOffset);
+			return static_cast<T>(Util::getBits<T>(this->ptr(), bitOffset, n) << (width - n));
+		}
+
+		return Util::getBits<T>(this->ptr(), bitOffset, width);
+
 	}
 
 };
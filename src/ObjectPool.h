@@ -0,0 +1,266 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef OBJECT_POOL_H_4C1BAB06_226A_4BEF_9D46_8CF1B6AC2A75
+#define OBJECT_POOL_H_4C1BAB06_226A_4BEF_9D46_8CF1B6AC2A75
+
+#include <stddef.h>
+#include <stdint.h>
+#include <new>
+
+/**
+ * Fixed-size object pools.
+ *
+ * An ObjectPool<T, N> reserves space for N objects of type T up front.
+ * Objects are constructed in place when acquired and destroyed when their
+ * PoolHandle goes out of scope, so the worst-case RAM footprint is known at
+ * compile time and nothing is ever allocated dynamically.
+ *
+ * Code which only needs to draw from a pool (eg. RadioPacket::parse) takes
+ * a Pool<T>&, so it does not depend on the pool's size.
+ *
+ * A pool must outlive every handle drawn from it.
+ */
+namespace RadioPacket {
+
+template<class T>
+class Pool;
+
+/**
+ * Storage for a single pooled object; free slots are chained together
+ * through next
+ */
+template<class T>
+union PoolSlot {
+	PoolSlot* next;
+	alignas(T) unsigned char object[sizeof(T)];
+};
+
+/**
+ * Owns an object drawn from a Pool and returns it to the pool when
+ * destroyed. Handles can be moved but not copied.
+ */
+template<class T>
+class PoolHandle {
+
+protected:
+
+	T* _obj = nullptr;
+	Pool<T>* _pool = nullptr;
+
+
+public:
+
+	PoolHandle() noexcept {
+	}
+
+	PoolHandle(T* const obj, Pool<T>* const pool) noexcept
+		: _obj(obj), _pool(pool) {
+	}
+
+	PoolHandle(PoolHandle&& h) noexcept
+		: _obj(h._obj), _pool(h._pool) {
+			h._obj = nullptr;
+			h._pool = nullptr;
+	}
+
+	PoolHandle(const PoolHandle& h) = delete;
+	PoolHandle& operator=(const PoolHandle& h) = delete;
+
+	PoolHandle& operator=(PoolHandle&& h) noexcept {
+
+		if(this != &h) {
+			this->reset();
+			this->_obj = h._obj;
+			this->_pool = h._pool;
+			h._obj = nullptr;
+			h._pool = nullptr;
+		}
+
+		return *this;
+
+	}
+
+	~PoolHandle() noexcept {
+		this->reset();
+	}
+
+	/**
+	 * Destroy the held object (if any) and return it to its pool
+	 */
+	void reset() noexcept {
+
+		if(this->_obj != nullptr) {
+			this->_pool->release(this->_obj);
+		}
+
+		this->_obj = nullptr;
+		this->_pool = nullptr;
+
+	}
+
+	T* get() const noexcept {
+		return this->_obj;
+	}
+
+	T* operator->() const noexcept {
+		return this->_obj;
+	}
+
+	T& operator*() const noexcept {
+		return *this->_obj;
+	}
+
+	explicit operator bool() const noexcept {
+		return this->_obj != nullptr;
+	}
+
+};
+
+template<class T>
+class Pool {
+
+protected:
+
+	/**
+	 * Head of the list of free slots
+	 */
+	PoolSlot<T>* _free = nullptr;
+
+	size_t _capacity = 0;
+	size_t _inUse = 0;
+	size_t _highWater = 0;
+
+	Pool() noexcept = default;
+	~Pool() noexcept = default;
+
+	/**
+	 * Chain len slots into the free list
+	 */
+	void _addSlots(PoolSlot<T>* const slots, const size_t len) noexcept {
+
+		for(size_t i = 0; i < len; ++i) {
+			slots[i].next = this->_free;
+			this->_free = &slots[i];
+		}
+
+		this->_capacity += len;
+
+	}
+
+
+public:
+
+	Pool(const Pool& p) = delete;
+	Pool& operator=(const Pool& p) = delete;
+
+	/**
+	 * Construct a T in a free slot with the given arguments. The returned
+	 * handle is empty if the pool is exhausted.
+	 */
+	template<class... Args>
+	PoolHandle<T> acquire(Args&&... args) noexcept {
+
+		if(this->_free == nullptr) {
+			return PoolHandle<T>();
+		}
+
+		PoolSlot<T>* const slot = this->_free;
+		this->_free = slot->next;
+
+		T* const obj = new (slot->object) T(static_cast<Args&&>(args)...);
+
+		if(++this->_inUse > this->_highWater) {
+			this->_highWater = this->_inUse;
+		}
+
+		return PoolHandle<T>(obj, this);
+
+	}
+
+	/**
+	 * Destroy obj and return its slot to the pool. Normally called by
+	 * PoolHandle; obj must have been acquired from this pool.
+	 */
+	void release(T* const obj) noexcept {
+
+		obj->~T();
+
+		PoolSlot<T>* const slot = reinterpret_cast<PoolSlot<T>*>(obj);
+		slot->next = this->_free;
+		this->_free = slot;
+
+		--this->_inUse;
+
+	}
+
+	/**
+	 * Total number of objects the pool can hold
+	 */
+	size_t capacity() const noexcept {
+		return this->_capacity;
+	}
+
+	/**
+	 * Number of objects currently acquired
+	 */
+	size_t inUse() const noexcept {
+		return this->_inUse;
+	}
+
+	/**
+	 * Number of objects which can still be acquired
+	 */
+	size_t available() const noexcept {
+		return this->_capacity - this->_inUse;
+	}
+
+	/**
+	 * Greatest number of objects acquired at the same time
+	 */
+	size_t highWaterMark() const noexcept {
+		return this->_highWater;
+	}
+
+};
+
+template<class T, size_t N>
+class ObjectPool : public Pool<T> {
+
+	static_assert(N > 0, "ObjectPool must hold at least one object");
+
+protected:
+
+	PoolSlot<T> _slots[N];
+
+
+public:
+
+	ObjectPool() noexcept {
+		this->_addSlots(this->_slots, N);
+	}
+
+};
+
+};
+
+#endif
@@ -0,0 +1,337 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef PACKET_BATCH_H_C73DAF8F_DED8_4467_8CA8_9C03646B4AF0
+#define PACKET_BATCH_H_C73DAF8F_DED8_4467_8CA8_9C03646B4AF0
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Crc.h"
+#include "MessageView.h"
+#include "RadioPacket.h"
+#include "RadioPacketView.h"
+#include "Util.h"
+
+/**
+ * A PacketBatch parses up to N packets held back-to-back in a contiguous
+ * capture buffer in a single pass, and stores their fields as columns
+ * (structure-of-arrays) rather than as one object per packet.
+ *
+ * Column i of every getter describes packet i. Filtering or aggregating
+ * packets by a field is then a loop over one contiguous array, eg.
+ *
+ * 	const uint16_t* tx = batch.getTransmitterIds();
+ *
+ * 	for(size_t i = 0; i < batch.size(); ++i) {
+ * 		matches += tx[i] == id;
+ * 	}
+ *
+ * Nothing is copied out of the capture buffer; bodies are referred to by
+ * offset, so the buffer must outlive the batch's contents.
+ *
+ * Packets of any version in KnownPacketLayouts may be mixed; each is
+ * parsed by code instantiated for its version's layout.
+ */
+namespace RadioPacket {
+
+template<size_t N>
+class PacketBatch {
+
+	static_assert(N > 0, "PacketBatch must hold at least one packet");
+
+protected:
+
+	const uint8_t* _buff = nullptr;
+	size_t _count = 0;
+	size_t _consumed = 0;
+
+	uint16_t _transmitterIds[N];
+	uint16_t _receiverIds[N];
+	uint8_t _versions[N];
+	uint8_t _fragmentNumbers[N];
+	uint16_t _sequenceNumbers[N];
+	uint16_t _messageIds[N];
+	size_t _bodyOffsets[N];
+	uint8_t _bodyLengths[N];
+	uint8_t _checksumValid[N];
+	uint16_t _actions[N];
+	uint8_t _hasMessage[N];
+
+	/**
+	 * Parse the packet at buff + offset into column i with the layout for
+	 * its version, returning its length, or 0 if it cannot be parsed
+	 */
+	template<class Layout>
+	uint16_t _parse(
+		const uint8_t* const buff,
+		const size_t len,
+		const size_t offset,
+		const size_t i) noexcept {
+
+			if(len - offset < Layout::HEADER_LEN) {
+				return 0;
+			}
+
+			const uint8_t* const p = buff + offset;
+			const uint8_t bodyLen = PacketHeader<Layout>::getBodyLength(p);
+			const uint16_t packetLen = Layout::HEADER_LEN + bodyLen;
+
+			if(p[Layout::PACKETLEN_OFFSET] != packetLen || len - offset < packetLen) {
+				return 0;
+			}
+
+			const uint8_t* const body = p + Layout::HEADER_LEN;
+
+			this->_transmitterIds[i] = PacketHeader<Layout>::getTransmitterId(p);
+			this->_receiverIds[i] = PacketHeader<Layout>::getReceiverId(p);
+			this->_versions[i] = Layout::VERSION;
+			this->_fragmentNumbers[i] = p[Layout::FRAGMENT_OFFSET];
+			this->_sequenceNumbers[i] = PacketHeader<Layout>::getSequenceNumber(p);
+			this->_messageIds[i] = PacketHeader<Layout>::getMessageId(p);
+			this->_bodyOffsets[i] = offset + Layout::HEADER_LEN;
+			this->_bodyLengths[i] = bodyLen;
+
+			const uint8_t crc = Crc8Ccitt::update(
+				Crc8Ccitt::update(Crc8Ccitt::init(), p, Layout::CRC8_OFFSET),
+				body,
+				bodyLen);
+
+			this->_checksumValid[i] = Crc8Ccitt::finalize(crc) == p[Layout::CRC8_OFFSET];
+
+			MessageView m;
+
+			//only a first fragment begins with a Message header; the body
+			//of any other is raw Message data
+			if(this->_fragmentNumbers[i] == 1 &&
+				MessageView::parse(&m, body, bodyLen) == Message::PARSE_OK) {
+				this->_actions[i] = m.getRawAction();
+				this->_hasMessage[i] = 1;
+			}
+			else {
+				this->_actions[i] = 0;
+				this->_hasMessage[i] = 0;
+			}
+
+			return packetLen;
+
+	}
+
+	/**
+	 * Calls _parse with the layout for a packet's version; see
+	 * PacketLayouts::dispatch
+	 */
+	struct LayoutParser {
+
+		PacketBatch* const batch;
+		const uint8_t* const buff;
+		const size_t len;
+		const size_t offset;
+		const size_t i;
+
+		template<class Layout>
+		uint16_t visit() const noexcept {
+			return this->batch->template _parse<Layout>(
+				this->buff,
+				this->len,
+				this->offset,
+				this->i);
+		}
+
+		uint16_t unknown() const noexcept {
+			return 0;
+		}
+
+	};
+
+
+public:
+
+	PacketBatch() noexcept {
+	}
+
+	PacketBatch(const PacketBatch& b) = delete;
+	PacketBatch& operator=(const PacketBatch& b) = delete;
+
+	/**
+	 * Parse the packets held back-to-back in buff, replacing the batch's
+	 * contents. Stops after N packets, at the end of buff, or at the first
+	 * packet whose version is unknown or whose packet and body lengths
+	 * disagree (as packet boundaries are then lost). Returns the number of
+	 * packets parsed.
+	 *
+	 * A packet with a bad checksum is still parsed; see getChecksumValid.
+	 * @param  {uint8_t*} const : capture buffer
+	 * @param  {size_t} len     : length of capture buffer
+	 * @return {size_t}         : number of packets parsed
+	 */
+	size_t parse(const uint8_t* const buff, const size_t len) noexcept {
+
+		size_t offset = 0;
+		size_t i = 0;
+
+		//the version byte must be present to tell how long the header is
+		for(; i < N && len - offset > RadioPacket::_VERSION_OFFSET; ++i) {
+
+			const LayoutParser parser = { this, buff, len, offset, i };
+			const uint16_t packetLen = KnownPacketLayouts::dispatch(
+				buff[offset + RadioPacket::_VERSION_OFFSET],
+				parser);
+
+			if(packetLen == 0) {
+				break;
+			}
+
+			offset += packetLen;
+
+		}
+
+		this->_buff = buff;
+		this->_count = i;
+		this->_consumed = offset;
+
+		return i;
+
+	}
+
+	/**
+	 * Number of packets in the batch
+	 * @return {size_t}  :
+	 */
+	size_t size() const noexcept {
+		return this->_count;
+	}
+
+	/**
+	 * Number of bytes of the capture buffer the batch's packets occupy;
+	 * parsing can resume from here
+	 * @return {size_t}  :
+	 */
+	size_t getConsumedLength() const noexcept {
+		return this->_consumed;
+	}
+
+	const uint16_t* getTransmitterIds() const noexcept {
+		return this->_transmitterIds;
+	}
+
+	const uint16_t* getReceiverIds() const noexcept {
+		return this->_receiverIds;
+	}
+
+	const uint8_t* getVersions() const noexcept {
+		return this->_versions;
+	}
+
+	const uint8_t* getFragmentNumbers() const noexcept {
+		return this->_fragmentNumbers;
+	}
+
+	/**
+	 * 0 where the packet's version has no sequence number
+	 * @return {uint16_t*}  :
+	 */
+	const uint16_t* getSequenceNumbers() const noexcept {
+		return this->_sequenceNumbers;
+	}
+
+	/**
+	 * 0 where the packet's version has no message ID
+	 * @return {uint16_t*}  :
+	 */
+	const uint16_t* getMessageIds() const noexcept {
+		return this->_messageIds;
+	}
+
+	/**
+	 * Offset of each packet's body from the start of the capture buffer
+	 * @return {size_t*}  :
+	 */
+	const size_t* getBodyOffsets() const noexcept {
+		return this->_bodyOffsets;
+	}
+
+	const uint8_t* getBodyLengths() const noexcept {
+		return this->_bodyLengths;
+	}
+
+	/**
+	 * 1 if the packet's CRC8 matched, otherwise 0
+	 * @return {uint8_t*}  :
+	 */
+	const uint8_t* getChecksumValid() const noexcept {
+		return this->_checksumValid;
+	}
+
+	/**
+	 * Action of the Message in each packet's body; 0 where getHasMessage
+	 * is 0, which includes aggregate packets (read those with an
+	 * AggregateIterator)
+	 * @return {uint16_t*}  :
+	 */
+	const uint16_t* getActions() const noexcept {
+		return this->_actions;
+	}
+
+	/**
+	 * 1 if the packet is fragment 1 and its body holds a whole, valid
+	 * Message, otherwise 0. Later fragments, the first fragment of a
+	 * Message too large for one packet, and aggregate packets (fragment
+	 * 0) are all 0.
+	 * @return {uint8_t*}  :
+	 */
+	const uint8_t* getHasMessage() const noexcept {
+		return this->_hasMessage;
+	}
+
+	/**
+	 * Returns a pointer to packet i's body data
+	 * @param  {size_t} i :
+	 * @return {uint8_t*} :
+	 */
+	const uint8_t* getBodyData(const size_t i) const noexcept {
+		return this->_buff + this->_bodyOffsets[i];
+	}
+
+	/**
+	 * Point v at packet i
+	 * @param  {size_t} i               :
+	 * @param  {RadioPacketView*} const :
+	 */
+	void getPacket(const size_t i, RadioPacketView* const v) const noexcept {
+
+		const uint8_t headerLen = KnownPacketLayouts::find(this->_versions[i])->headerLength;
+
+		RadioPacketView::parse(
+			v,
+			this->getBodyData(i) - headerLen,
+			headerLen + this->_bodyLengths[i]);
+
+	}
+
+};
+
+};
+
+#endif
@@ -0,0 +1,190 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PacketEncoder.h"
+
+#include <string.h>
+#include "Compression.h"
+#include "Crc.h"
+#include "Util.h"
+
+namespace RadioPacket {
+
+PacketEncoder::PacketEncoder() noexcept {
+	::memcpy(this->_header, RadioPacket::_DEFAULT_HEADER, RadioPacket::getHeaderLength());
+}
+
+void PacketEncoder::setRawVersion(const uint8_t version) noexcept {
+
+	const PacketFormat* const to = KnownPacketLayouts::find(version);
+
+	if(to == nullptr || to == this->_format) {
+		this->_header[RadioPacket::_VERSION_OFFSET] = version;
+		return;
+	}
+
+	uint8_t header[RadioPacket::_MAX_HEADER_LEN];
+	::memcpy(header, this->_header, this->_format->headerLength);
+
+	PacketFormat::convertHeader(*this->_format, header, *to, this->_header);
+	this->_format = to;
+
+	HeaderWriterSelector selector;
+	this->_headerWriter = KnownPacketLayouts::dispatch(version, selector);
+
+}
+
+bool PacketEncoder::setRawTransmitterId(const uint16_t id) noexcept {
+	return this->_format->setAddress(&this->_header[this->_format->transmitterIdOffset], id);
+}
+
+bool PacketEncoder::setRawReceiverId(const uint16_t id) noexcept {
+	return this->_format->setAddress(&this->_header[this->_format->receiverIdOffset], id);
+}
+
+void PacketEncoder::setRawFragmentNumber(const uint8_t n) noexcept {
+	this->_header[this->_format->fragmentOffset] = n;
+}
+
+void PacketEncoder::setRawSequenceNumber(const uint16_t n) noexcept {
+	this->_sequenceNumber = n;
+}
+
+void PacketEncoder::setRawMessageId(const uint16_t id) noexcept {
+	if(this->_format->hasMessageId()) {
+		const uint16_t netuint = (Util::htons)(id);
+		::memcpy(&this->_header[this->_format->messageIdOffset], &netuint, sizeof(uint16_t));
+	}
+}
+
+uint16_t PacketEncoder::getRawSequenceNumber() const noexcept {
+	return this->_sequenceNumber;
+}
+
+const PacketFormat* PacketEncoder::getFormat() const noexcept {
+	return this->_format;
+}
+
+uint8_t PacketEncoder::getMaxBodyLength() const noexcept {
+	return this->_format->getMaxBodyLength();
+}
+
+uint8_t PacketEncoder::encode(
+	uint8_t* const buff,
+	const uint8_t* const body,
+	const uint8_t len) noexcept {
+
+		if(len > this->getMaxBodyLength()) {
+			return 0;
+		}
+
+		const uint8_t headerLen = this->_format->headerLength;
+		uint8_t crc = this->_writeHeader(buff, len);
+
+		crc = Crc8Ccitt::updateCopy(
+			crc,
+			buff + headerLen,
+			body,
+			len);
+
+		buff[this->_format->crc8Offset] = Crc8Ccitt::finalize(crc);
+
+		return headerLen + len;
+
+}
+
+uint8_t PacketEncoder::_writeMessage(
+	uint8_t* const buff,
+	const uint16_t action,
+	const uint8_t* const body,
+	const uint8_t bodyLen,
+	const bool copyBody) noexcept {
+
+		uint8_t* const msg = buff + this->_format->headerLength;
+		uint8_t msgHeader[Message::getHeaderLength()];
+		const uint16_t netLen = (Util::htons)(bodyLen);
+		const uint16_t netAction = (Util::htons)(action);
+
+		::memcpy(&msgHeader[Message::_BODYLEN_OFFSET], &netLen, sizeof(uint16_t));
+		::memcpy(&msgHeader[Message::_ACTION_OFFSET], &netAction, sizeof(uint16_t));
+
+		uint8_t crc = this->_writeHeader(buff, Message::getHeaderLength() + bodyLen);
+		crc = Crc8Ccitt::updateCopy(crc, msg, msgHeader, Message::getHeaderLength());
+
+		crc = copyBody
+			? Crc8Ccitt::updateCopy(crc, msg + Message::getHeaderLength(), body, bodyLen)
+			: Crc8Ccitt::update(crc, msg + Message::getHeaderLength(), bodyLen);
+
+		buff[this->_format->crc8Offset] = Crc8Ccitt::finalize(crc);
+
+		return this->_format->headerLength + Message::getHeaderLength() + bodyLen;
+
+}
+
+uint8_t PacketEncoder::encodeMessage(
+	uint8_t* const buff,
+	const uint16_t action,
+	const uint8_t* const payload,
+	const uint8_t len) noexcept {
+
+		//a receiver would try to decompress the body
+		if(Compression::isCompressed(action) ||
+			len > this->getMaxBodyLength() - Message::getHeaderLength()) {
+				return 0;
+		}
+
+		return this->_writeMessage(buff, action, payload, len, true);
+
+}
+
+uint8_t PacketEncoder::encodeMessage(
+	uint8_t* const buff,
+	const uint16_t action,
+	const uint8_t* const payload,
+	const uint8_t len,
+	const uint8_t codec,
+	const CompressionDictionary* const dict) noexcept {
+
+		if(Compression::isCompressed(action)) {
+			return 0;
+		}
+
+		const uint8_t maxPayloadLen = this->getMaxBodyLength() - Message::getHeaderLength();
+		uint8_t* const body = buff + this->_format->headerLength + Message::getHeaderLength();
+
+		const size_t n = Compression::compress(codec, payload, len, body, maxPayloadLen, dict);
+
+		if(n == 0) {
+			return this->encodeMessage(buff, action, payload, len);
+		}
+
+		return this->_writeMessage(
+			buff,
+			action | Compression::ACTION_FLAG,
+			body,
+			static_cast<uint8_t>(n),
+			false);
+
+}
+
+};
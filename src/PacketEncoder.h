@@ -0,0 +1,275 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef PACKET_ENCODER_H_8086FD54_F842_4968_A89A_F81B262BC958
+#define PACKET_ENCODER_H_8086FD54_F842_4968_A89A_F81B262BC958
+
+#include <stdint.h>
+#include <string.h>
+
+#include "Crc.h"
+#include "Message.h"
+#include "RadioPacket.h"
+#include "Util.h"
+
+/**
+ * A PacketEncoder serialises a packet straight into a caller's buffer,
+ * without building a Message or RadioPacket first.
+ *
+ * The packet header, the Message header (if any) and the body are written
+ * in a single forward pass, and the CRC8 is calculated as the bytes are
+ * written. The buffer then holds a complete packet, ready to be
+ * transmitted. Compared to building a Message and a RadioPacket, the body
+ * is copied once instead of twice and is not read again to generate the
+ * checksum.
+ *
+ * Header fields are set once and reused for every packet encoded. With a
+ * version 2 header, the sequence number is stamped into each packet and
+ * then incremented.
+ *
+ * 	uint8_t buff[RadioPacket::getMaxPacketLength()];
+ * 	PacketEncoder e;
+ * 	e.setRawReceiverId(RECEIVER_ID);
+ *
+ * 	const uint8_t len = e.encodeMessage(buff, UPDATE_DB_CMD, arr, sizeof(arr));
+ * 	man.transmitArray(len, buff);
+ */
+namespace RadioPacket {
+
+struct CompressionDictionary;
+class Fragmenter;
+class MessageAggregator;
+
+class PacketEncoder {
+
+protected:
+
+	/**
+	 * Packet header; the packet length, body length and CRC are filled in
+	 * as each packet is encoded
+	 */
+	uint8_t _header[RadioPacket::_MAX_HEADER_LEN];
+
+	/**
+	 * Layout of _header, selected by its version
+	 */
+	const PacketFormat* _format = &PacketLayout<1>::FORMAT;
+
+	/**
+	 * Sequence number of the next packet encoded
+	 */
+	uint16_t _sequenceNumber = 0;
+
+	/**
+	 * Write the packet header for a body of bodyLen bytes into buff,
+	 * except for the CRC, and return the CRC register so far
+	 */
+	template<class Layout>
+	uint8_t _writeHeaderAs(uint8_t* const buff, const uint8_t bodyLen) noexcept {
+
+		PacketHeader<Layout>::setBodyLength(this->_header, bodyLen);
+
+		if(Layout::SEQUENCE_OFFSET != 0) {
+			const uint16_t netuint = (Util::htons)(this->_sequenceNumber++);
+			::memcpy(&this->_header[Layout::SEQUENCE_OFFSET], &netuint, sizeof(uint16_t));
+		}
+
+		//the crc excludes itself; it is written once the body is done
+		return Crc8Ccitt::updateCopy(
+			Crc8Ccitt::init(),
+			buff,
+			this->_header,
+			Layout::CRC8_OFFSET);
+
+	}
+
+	/**
+	 * _writeHeaderAs for the layout of _header, chosen when the version
+	 * is set so that encoding a packet does not look at the layout
+	 */
+	uint8_t (PacketEncoder::*_headerWriter)(uint8_t* const, const uint8_t) =
+		&PacketEncoder::_writeHeaderAs<PacketLayout<1>>;
+
+	/**
+	 * Picks _headerWriter for a layout
+	 */
+	struct HeaderWriterSelector {
+
+		typedef uint8_t (PacketEncoder::*Writer)(uint8_t* const, const uint8_t);
+
+		template<class Layout>
+		Writer visit() const noexcept {
+			return &PacketEncoder::_writeHeaderAs<Layout>;
+		}
+
+		Writer unknown() const noexcept {
+			return nullptr;
+		}
+
+	};
+
+	inline uint8_t _writeHeader(uint8_t* const buff, const uint8_t bodyLen) noexcept {
+		return (this->*_headerWriter)(buff, bodyLen);
+	}
+
+	/**
+	 * Write the Message header, which is followed by bodyLen bytes
+	 * already in place, and the packet header around it into buff
+	 */
+	uint8_t _writeMessage(
+		uint8_t* const buff,
+		const uint16_t action,
+		const uint8_t* const body,
+		const uint8_t bodyLen,
+		const bool copyBody) noexcept;
+
+	friend class Fragmenter;
+	friend class MessageAggregator;
+
+
+public:
+
+	/**
+	 * Largest payload encodeMessage can fit in a single packet with a
+	 * version 1 header; see getMaxBodyLength for the current version
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getMaxPayloadLength() noexcept {
+		return RadioPacket::getMaxBodyLength() - Message::getHeaderLength();
+	}
+
+	PacketEncoder() noexcept;
+	PacketEncoder(const PacketEncoder& e) noexcept = default;
+	PacketEncoder& operator=(const PacketEncoder& e) noexcept = default;
+
+	/**
+	 * Set the version. If the version has a known layout, the header is
+	 * converted to it; any other version is written as-is and the current
+	 * layout is kept.
+	 * @param  {uint8_t} version :
+	 */
+	void setRawVersion(const uint8_t version) noexcept;
+
+	/**
+	 * Set the transmitter or receiver ID. Version 3 headers carry a
+	 * short address from an AddressMap, or PacketFormat::BROADCAST_ID;
+	 * a larger value is written as PacketFormat::UNASSIGNED_ADDRESS and
+	 * false is returned. Set the version first.
+	 * @param  {uint16_t} id :
+	 * @return {bool}        :
+	 */
+	bool setRawTransmitterId(const uint16_t id) noexcept;
+	bool setRawReceiverId(const uint16_t id) noexcept;
+	void setRawFragmentNumber(const uint8_t n) noexcept;
+
+	/**
+	 * Set the sequence number of the next packet encoded; those after it
+	 * follow on. Has no effect on the packets of a version without one.
+	 * @param  {uint16_t} n :
+	 */
+	void setRawSequenceNumber(const uint16_t n) noexcept;
+
+	/**
+	 * Ignored if the version has no message ID
+	 * @param  {uint16_t} id :
+	 */
+	void setRawMessageId(const uint16_t id) noexcept;
+
+	/**
+	 * Sequence number the next packet encoded will carry
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getRawSequenceNumber() const noexcept;
+
+	/**
+	 * Layout of the header being encoded
+	 * @return {PacketFormat*}  :
+	 */
+	const PacketFormat* getFormat() const noexcept;
+
+	/**
+	 * Largest body encode can fit in a single packet with the current
+	 * version
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getMaxBodyLength() const noexcept;
+
+	/**
+	 * Encode a packet whose body is len bytes of body into buff and return
+	 * its length, or 0 if len exceeds getMaxBodyLength().
+	 * Calling code must ensure buff has sufficient space
+	 * @param  {uint8_t*} const : destination buffer
+	 * @param  {uint8_t*} const : body
+	 * @param  {uint8_t} len    : body length
+	 * @return {uint8_t}        : packet length
+	 */
+	uint8_t encode(
+		uint8_t* const buff,
+		const uint8_t* const body,
+		const uint8_t len) noexcept;
+
+	/**
+	 * Encode a packet holding a Message with the given action and len
+	 * bytes of payload into buff and return its length, or 0 if the
+	 * Message would exceed getMaxBodyLength() or action has
+	 * Compression::ACTION_FLAG set.
+	 * Calling code must ensure buff has sufficient space
+	 * @param  {uint8_t*} const : destination buffer
+	 * @param  {uint16_t} action : Message action, below Compression::ACTION_FLAG
+	 * @param  {uint8_t*} const : Message body
+	 * @param  {uint8_t} len    : Message body length
+	 * @return {uint8_t}        : packet length
+	 */
+	uint8_t encodeMessage(
+		uint8_t* const buff,
+		const uint16_t action,
+		const uint8_t* const payload,
+		const uint8_t len) noexcept;
+
+	/**
+	 * As above, but the payload is compressed with codec straight into
+	 * buff (see Compression). If that does not make it shorter, it is sent
+	 * uncompressed. As the payload only needs to fit once compressed, len
+	 * may exceed getMaxPayloadLength(); if it then does not compress
+	 * enough, 0 is returned, as it is for an action with
+	 * Compression::ACTION_FLAG set.
+	 * @param  {uint8_t*} const              : destination buffer
+	 * @param  {uint16_t} action             : Message action, below Compression::ACTION_FLAG
+	 * @param  {uint8_t*} const              : Message body
+	 * @param  {uint8_t} len                 : Message body length
+	 * @param  {uint8_t} codec               : one of the Compression::CODEC_* constants
+	 * @param  {CompressionDictionary*} dict : for Compression::CODEC_LZ; nullptr for none
+	 * @return {uint8_t}                     : packet length
+	 */
+	uint8_t encodeMessage(
+		uint8_t* const buff,
+		const uint16_t action,
+		const uint8_t* const payload,
+		const uint8_t len,
+		const uint8_t codec,
+		const CompressionDictionary* const dict = nullptr) noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,95 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "PacketLayout.h"
+
+#include <string.h>
+
+namespace RadioPacket {
+
+/**
+ * Read an ID from a header laid out as from, as setAddress takes it;
+ * setAddress then keeps broadcast as broadcast and does not truncate an
+ * ID too large for a short address
+ */
+static uint16_t readAddress(
+	const PacketFormat& from,
+	const uint8_t* const p) noexcept {
+
+		const uint16_t id = from.getAddress(p);
+
+		return from.hasShortAddresses() && id == PacketFormat::BROADCAST_ADDRESS
+			? PacketFormat::BROADCAST_ID
+			: id;
+
+}
+
+uint8_t PacketFormat::convertHeader(
+	const PacketFormat& from,
+	const uint8_t* const src,
+	const PacketFormat& to,
+	uint8_t* const dst) noexcept {
+
+		uint8_t bodyLen = from.getBodyLength(src);
+
+		if(bodyLen > to.getMaxBodyLength()) {
+			bodyLen = to.getMaxBodyLength();
+		}
+
+		::memset(dst, 0, to.headerLength);
+
+		dst[PacketLayout<1>::PACKETLEN_OFFSET] = to.headerLength + bodyLen;
+		dst[PacketLayout<1>::VERSION_OFFSET] = to.version;
+		dst[to.fragmentOffset] = src[from.fragmentOffset];
+
+		if(to.hasBodyLength()) {
+			dst[to.bodyLengthOffset] = bodyLen;
+		}
+
+		to.setAddress(&dst[to.transmitterIdOffset], readAddress(from, &src[from.transmitterIdOffset]));
+		to.setAddress(&dst[to.receiverIdOffset], readAddress(from, &src[from.receiverIdOffset]));
+
+		//multi-byte fields are in network byte order in both, so are
+		//copied as they are
+
+		if(from.hasSequenceNumber() && to.hasSequenceNumber()) {
+			::memcpy(&dst[to.sequenceNumberOffset], &src[from.sequenceNumberOffset], sizeof(uint16_t));
+		}
+
+		if(from.hasMessageId() && to.hasMessageId()) {
+			::memcpy(&dst[to.messageIdOffset], &src[from.messageIdOffset], sizeof(uint16_t));
+		}
+
+		return bodyLen;
+
+}
+
+const uint16_t PacketFormat::BROADCAST_ID;
+const uint8_t PacketFormat::BROADCAST_ADDRESS;
+const uint8_t PacketFormat::UNASSIGNED_ADDRESS;
+
+constexpr PacketFormat PacketLayout<1>::FORMAT;
+constexpr PacketFormat PacketLayout<2>::FORMAT;
+constexpr PacketFormat PacketLayout<3>::FORMAT;
+
+};
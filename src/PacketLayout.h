@@ -0,0 +1,489 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef PACKET_LAYOUT_H_94A514A9_0326_4281_B9AC_90F7BE5D8590
+#define PACKET_LAYOUT_H_94A514A9_0326_4281_B9AC_90F7BE5D8590
+
+#include <stdint.h>
+
+/**
+ * The packet header is versioned. Every version begins with the packet
+ * length and the version, so the layout of the rest of a packet can be
+ * chosen from its second byte, and every version ends with the CRC8, so
+ * the checksum always covers the header up to its last byte.
+ *
+ * Version 1:
+ *
+ * 	HEADER	| 0x0 - 0x0				[ PACKET LENGTH, 1 byte, unsigned ]
+ * 			| 0x1 - 0x1				[ VERSION, 1 byte, unsigned ]
+ * 			| 0x2 - 0x3				[ TRANSMITTER ID, 2 bytes, unsigned ]
+ * 			| 0x4 - 0x5				[ RECEIVER ID, 2 bytes, unsigned ]
+ * 			| 0x6 - 0x6				[ FRAGMENT, 1 byte, unsigned ]
+ * 			| 0x7 - 0x7				[ BODY LENGTH, 1 byte, unsigned ]
+ * 			| 0x8 - 0x8				[ CRC8, 1 byte, unsigned ]
+ * 	BODY	| 0x9 - {BODY LENGTH-1}	[ BODY DATA ]
+ *
+ * Version 2 adds a sequence number, which a transmitter increments for
+ * each packet it sends, and a message ID, which is shared by every
+ * fragment of one message:
+ *
+ * 	HEADER	| 0x0 - 0x0				[ PACKET LENGTH, 1 byte, unsigned ]
+ * 			| 0x1 - 0x1				[ VERSION, 1 byte, unsigned ]
+ * 			| 0x2 - 0x3				[ TRANSMITTER ID, 2 bytes, unsigned ]
+ * 			| 0x4 - 0x5				[ RECEIVER ID, 2 bytes, unsigned ]
+ * 			| 0x6 - 0x6				[ FRAGMENT, 1 byte, unsigned ]
+ * 			| 0x7 - 0x7				[ BODY LENGTH, 1 byte, unsigned ]
+ * 			| 0x8 - 0x9				[ SEQUENCE NUMBER, 2 bytes, unsigned ]
+ * 			| 0xA - 0xB				[ MESSAGE ID, 2 bytes, unsigned ]
+ * 			| 0xC - 0xC				[ CRC8, 1 byte, unsigned ]
+ * 	BODY	| 0xD - {BODY LENGTH-1}	[ BODY DATA ]
+ *
+ * Version 3 is a compact header for small frames between nodes of one
+ * network. Transmitter and receiver are 8 bit short addresses (see
+ * AddressMap), and there is no body length; it is the packet length less
+ * the header length:
+ *
+ * 	HEADER	| 0x0 - 0x0				[ PACKET LENGTH, 1 byte, unsigned ]
+ * 			| 0x1 - 0x1				[ VERSION, 1 byte, unsigned ]
+ * 			| 0x2 - 0x2				[ TRANSMITTER ADDRESS, 1 byte, unsigned ]
+ * 			| 0x3 - 0x3				[ RECEIVER ADDRESS, 1 byte, unsigned ]
+ * 			| 0x4 - 0x4				[ FRAGMENT, 1 byte, unsigned ]
+ * 			| 0x5 - 0x5				[ CRC8, 1 byte, unsigned ]
+ * 	BODY	| 0x6 - {PACKET LENGTH-1}	[ BODY DATA ]
+ *
+ * Each version's layout is a PacketLayout specialisation, whose offsets
+ * are compile-time constants. Code which handles one packet at a time
+ * dispatches on the version byte to a template instantiated for each
+ * layout (see PacketLayouts::dispatch); code which holds onto a packet
+ * keeps a pointer to its layout's PacketFormat.
+ */
+namespace RadioPacket {
+
+/**
+ * The offsets of one version's header fields, for use at runtime
+ *
+ * The packet length is always at offset 0, so an offset of 0 marks a
+ * field the version does not have.
+ */
+struct PacketFormat {
+
+	uint8_t version;
+	uint8_t headerLength;
+	uint8_t transmitterIdOffset;
+	uint8_t receiverIdOffset;
+	uint8_t fragmentOffset;
+	uint8_t bodyLengthOffset;
+	uint8_t sequenceNumberOffset;
+	uint8_t messageIdOffset;
+	uint8_t crc8Offset;
+
+	/**
+	 * Width of the transmitter and receiver IDs in bytes: 2, or 1 for
+	 * short addresses
+	 */
+	uint8_t addressLength;
+
+	/**
+	 * The receiver ID, and short address, which every node accepts
+	 */
+	static const uint16_t BROADCAST_ID = 0xffff;
+	static const uint8_t BROADCAST_ADDRESS = 0xff;
+
+	/**
+	 * The short address of an ID too large for one, which no node is
+	 * given; see setAddress
+	 */
+	static const uint8_t UNASSIGNED_ADDRESS = 0x00;
+
+	constexpr uint8_t getMaxBodyLength() const noexcept {
+		return 0xff - headerLength;
+	}
+
+	constexpr bool hasBodyLength() const noexcept {
+		return bodyLengthOffset != 0;
+	}
+
+	constexpr bool hasShortAddresses() const noexcept {
+		return addressLength == 1;
+	}
+
+	/**
+	 * Body length of a header in this layout, from its body length field
+	 * or else its packet length
+	 * @param  {uint8_t*} const header :
+	 * @return {uint8_t}               :
+	 */
+	inline uint8_t getBodyLength(const uint8_t* const header) const noexcept {
+		return this->hasBodyLength()
+			? header[this->bodyLengthOffset]
+			: static_cast<uint8_t>(header[0] - this->headerLength);
+	}
+
+	/**
+	 * Read a transmitter or receiver ID at p, in network byte order
+	 * @param  {uint8_t*} const p :
+	 * @return {uint16_t}         :
+	 */
+	inline uint16_t getAddress(const uint8_t* const p) const noexcept {
+		return this->hasShortAddresses()
+			? p[0]
+			: static_cast<uint16_t>((p[0] << 8) | p[1]);
+	}
+
+	/**
+	 * Write a transmitter or receiver ID at p. For short addresses, id is
+	 * a short address (see AddressMap) or BROADCAST_ID, which is written
+	 * as BROADCAST_ADDRESS; anything from BROADCAST_ADDRESS up is written
+	 * as UNASSIGNED_ADDRESS rather than keep its low byte, which could
+	 * alias another node or broadcast, and false is returned.
+	 * @param  {uint8_t*} const p :
+	 * @param  {uint16_t} id      :
+	 * @return {bool}             :
+	 */
+	inline bool setAddress(uint8_t* const p, const uint16_t id) const noexcept {
+
+		if(!this->hasShortAddresses()) {
+			p[0] = static_cast<uint8_t>(id >> 8);
+			p[1] = static_cast<uint8_t>(id);
+			return true;
+		}
+
+		if(id == BROADCAST_ID) {
+			p[0] = BROADCAST_ADDRESS;
+			return true;
+		}
+
+		if(id >= BROADCAST_ADDRESS) {
+			p[0] = UNASSIGNED_ADDRESS;
+			return false;
+		}
+
+		p[0] = static_cast<uint8_t>(id);
+		return true;
+
+	}
+
+	constexpr bool hasSequenceNumber() const noexcept {
+		return sequenceNumberOffset != 0;
+	}
+
+	constexpr bool hasMessageId() const noexcept {
+		return messageIdOffset != 0;
+	}
+
+	/**
+	 * Write the header in src, laid out as from, into dst laid out as to.
+	 * The body length is clamped to what to can carry and the packet
+	 * length follows it; fields to lacks are dropped and fields from
+	 * lacks are zeroed. The CRC8 is zeroed. Returns the body length.
+	 *
+	 * Broadcast stays broadcast either way. IDs which fit in a short
+	 * address keep their value; any larger becomes UNASSIGNED_ADDRESS, as
+	 * in setAddress. Set them again through an AddressMap when converting
+	 * to or from short addresses.
+	 * src and dst must not overlap.
+	 * @param  {PacketFormat} from :
+	 * @param  {uint8_t*} src      :
+	 * @param  {PacketFormat} to   :
+	 * @param  {uint8_t*} dst      :
+	 * @return {uint8_t}           : body length
+	 */
+	static uint8_t convertHeader(
+		const PacketFormat& from,
+		const uint8_t* const src,
+		const PacketFormat& to,
+		uint8_t* const dst) noexcept;
+
+};
+
+/**
+ * Header layout of the given version
+ */
+template<uint8_t Version>
+struct PacketLayout;
+
+template<>
+struct PacketLayout<1> {
+
+	static const uint8_t VERSION = 1;
+	static const uint8_t HEADER_LEN = 9;
+	static const uint8_t PACKETLEN_OFFSET = 0x0;
+	static const uint8_t VERSION_OFFSET = 0x1;
+	static const uint8_t TRANSMITTERID_OFFSET = 0x2;
+	static const uint8_t RECEIVERID_OFFSET = 0x4;
+	static const uint8_t FRAGMENT_OFFSET = 0x6;
+	static const uint8_t BODYLEN_OFFSET = 0x7;
+	static const uint8_t SEQUENCE_OFFSET = 0x0;
+	static const uint8_t MESSAGEID_OFFSET = 0x0;
+	static const uint8_t CRC8_OFFSET = 0x8;
+	static const uint8_t MAX_BODY_LEN = 0xff - HEADER_LEN;
+	static const uint8_t ADDRESS_LEN = 2;
+
+	static constexpr PacketFormat FORMAT = {
+		VERSION,
+		HEADER_LEN,
+		TRANSMITTERID_OFFSET,
+		RECEIVERID_OFFSET,
+		FRAGMENT_OFFSET,
+		BODYLEN_OFFSET,
+		SEQUENCE_OFFSET,
+		MESSAGEID_OFFSET,
+		CRC8_OFFSET,
+		ADDRESS_LEN
+	};
+
+};
+
+template<>
+struct PacketLayout<2> {
+
+	static const uint8_t VERSION = 2;
+	static const uint8_t HEADER_LEN = 13;
+	static const uint8_t PACKETLEN_OFFSET = 0x0;
+	static const uint8_t VERSION_OFFSET = 0x1;
+	static const uint8_t TRANSMITTERID_OFFSET = 0x2;
+	static const uint8_t RECEIVERID_OFFSET = 0x4;
+	static const uint8_t FRAGMENT_OFFSET = 0x6;
+	static const uint8_t BODYLEN_OFFSET = 0x7;
+	static const uint8_t SEQUENCE_OFFSET = 0x8;
+	static const uint8_t MESSAGEID_OFFSET = 0xA;
+	static const uint8_t CRC8_OFFSET = 0xC;
+	static const uint8_t MAX_BODY_LEN = 0xff - HEADER_LEN;
+	static const uint8_t ADDRESS_LEN = 2;
+
+	static constexpr PacketFormat FORMAT = {
+		VERSION,
+		HEADER_LEN,
+		TRANSMITTERID_OFFSET,
+		RECEIVERID_OFFSET,
+		FRAGMENT_OFFSET,
+		BODYLEN_OFFSET,
+		SEQUENCE_OFFSET,
+		MESSAGEID_OFFSET,
+		CRC8_OFFSET,
+		ADDRESS_LEN
+	};
+
+};
+
+template<>
+struct PacketLayout<3> {
+
+	static const uint8_t VERSION = 3;
+	static const uint8_t HEADER_LEN = 6;
+	static const uint8_t PACKETLEN_OFFSET = 0x0;
+	static const uint8_t VERSION_OFFSET = 0x1;
+	static const uint8_t TRANSMITTERID_OFFSET = 0x2;
+	static const uint8_t RECEIVERID_OFFSET = 0x3;
+	static const uint8_t FRAGMENT_OFFSET = 0x4;
+	static const uint8_t BODYLEN_OFFSET = 0x0;
+	static const uint8_t SEQUENCE_OFFSET = 0x0;
+	static const uint8_t MESSAGEID_OFFSET = 0x0;
+	static const uint8_t CRC8_OFFSET = 0x5;
+	static const uint8_t MAX_BODY_LEN = 0xff - HEADER_LEN;
+	static const uint8_t ADDRESS_LEN = 1;
+
+	static constexpr PacketFormat FORMAT = {
+		VERSION,
+		HEADER_LEN,
+		TRANSMITTERID_OFFSET,
+		RECEIVERID_OFFSET,
+		FRAGMENT_OFFSET,
+		BODYLEN_OFFSET,
+		SEQUENCE_OFFSET,
+		MESSAGEID_OFFSET,
+		CRC8_OFFSET,
+		ADDRESS_LEN
+	};
+
+};
+
+/**
+ * Reads and writes the fields of a header laid out as Layout. The offsets
+ * and widths are constants, so the tests below are resolved at compile
+ * time and each field is a fixed load or store.
+ */
+template<class Layout>
+class PacketHeader {
+
+protected:
+
+	static inline uint16_t _readAddress(const uint8_t* const p) noexcept {
+		return Layout::ADDRESS_LEN == 1
+			? p[0]
+			: static_cast<uint16_t>((p[0] << 8) | p[1]);
+	}
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	PacketHeader();
+
+
+public:
+
+	/**
+	 * Callers must first check the packet length is at least
+	 * Layout::HEADER_LEN
+	 * @param  {uint8_t*} const header :
+	 * @return {uint8_t}               :
+	 */
+	static inline uint8_t getBodyLength(const uint8_t* const header) noexcept {
+		return Layout::BODYLEN_OFFSET != 0
+			? header[Layout::BODYLEN_OFFSET]
+			: static_cast<uint8_t>(header[Layout::PACKETLEN_OFFSET] - Layout::HEADER_LEN);
+	}
+
+	/**
+	 * Write the packet length, and the body length if the layout has one
+	 * @param  {uint8_t*} const header :
+	 * @param  {uint8_t} bodyLen       :
+	 */
+	static inline void setBodyLength(uint8_t* const header, const uint8_t bodyLen) noexcept {
+
+		header[Layout::PACKETLEN_OFFSET] = Layout::HEADER_LEN + bodyLen;
+
+		if(Layout::BODYLEN_OFFSET != 0) {
+			header[Layout::BODYLEN_OFFSET] = bodyLen;
+		}
+
+	}
+
+	static inline uint16_t getTransmitterId(const uint8_t* const header) noexcept {
+		return _readAddress(header + Layout::TRANSMITTERID_OFFSET);
+	}
+
+	static inline uint16_t getReceiverId(const uint8_t* const header) noexcept {
+		return _readAddress(header + Layout::RECEIVERID_OFFSET);
+	}
+
+	static inline uint16_t getSequenceNumber(const uint8_t* const header) noexcept {
+		return Layout::SEQUENCE_OFFSET != 0
+			? static_cast<uint16_t>((header[Layout::SEQUENCE_OFFSET] << 8) | header[Layout::SEQUENCE_OFFSET + 1])
+			: 0;
+	}
+
+	static inline uint16_t getMessageId(const uint8_t* const header) noexcept {
+		return Layout::MESSAGEID_OFFSET != 0
+			? static_cast<uint16_t>((header[Layout::MESSAGEID_OFFSET] << 8) | header[Layout::MESSAGEID_OFFSET + 1])
+			: 0;
+	}
+
+};
+
+/**
+ * A list of layouts, searched in order for a version
+ */
+template<class... Layouts>
+struct PacketLayouts;
+
+template<>
+struct PacketLayouts<> {
+
+	static constexpr uint8_t getMinHeaderLength() noexcept {
+		return 0xff;
+	}
+
+	static constexpr uint8_t getMaxHeaderLength() noexcept {
+		return 0;
+	}
+
+	static inline const PacketFormat* find(const uint8_t) noexcept {
+		return nullptr;
+	}
+
+	template<class Visitor>
+	static inline auto dispatch(const uint8_t, Visitor& v) noexcept
+		-> decltype(v.unknown()) {
+			return v.unknown();
+	}
+
+};
+
+template<class Layout, class... Layouts>
+struct PacketLayouts<Layout, Layouts...> {
+
+	static_assert(Layout::PACKETLEN_OFFSET == 0 && Layout::VERSION_OFFSET == 1,
+		"Every layout must begin with the packet length and version");
+	static_assert(Layout::CRC8_OFFSET == Layout::HEADER_LEN - 1,
+		"Every layout must end with the CRC8");
+
+	/**
+	 * Shortest header of any layout in the list
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getMinHeaderLength() noexcept {
+		return Layout::HEADER_LEN < PacketLayouts<Layouts...>::getMinHeaderLength()
+			? Layout::HEADER_LEN
+			: PacketLayouts<Layouts...>::getMinHeaderLength();
+	}
+
+	/**
+	 * Longest header of any layout in the list
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getMaxHeaderLength() noexcept {
+		return Layout::HEADER_LEN > PacketLayouts<Layouts...>::getMaxHeaderLength()
+			? Layout::HEADER_LEN
+			: PacketLayouts<Layouts...>::getMaxHeaderLength();
+	}
+
+	/**
+	 * Returns the format of the given version, or nullptr if there is no
+	 * layout for it
+	 * @param  {uint8_t} version :
+	 * @return {PacketFormat*}   :
+	 */
+	static inline const PacketFormat* find(const uint8_t version) noexcept {
+		return version == Layout::VERSION
+			? &Layout::FORMAT
+			: PacketLayouts<Layouts...>::find(version);
+	}
+
+	/**
+	 * Call v.template visit<L>() for the layout L of the given version, or
+	 * v.unknown() if there is no layout for it. The comparisons unroll at
+	 * compile time, and each visit is instantiated with its layout's
+	 * offsets as constants.
+	 * @param  {uint8_t} version :
+	 * @param  {Visitor&} v      :
+	 * @return {auto}            : whatever v returns
+	 */
+	template<class Visitor>
+	static inline auto dispatch(const uint8_t version, Visitor& v) noexcept
+		-> decltype(v.unknown()) {
+			return version == Layout::VERSION
+				? v.template visit<Layout>()
+				: PacketLayouts<Layouts...>::dispatch(version, v);
+	}
+
+};
+
+/**
+ * Every version this library can parse
+ */
+typedef PacketLayouts<PacketLayout<1>, PacketLayout<2>, PacketLayout<3>> KnownPacketLayouts;
+
+};
+
+#endif
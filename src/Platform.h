@@ -0,0 +1,89 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef PLATFORM_H_497F17CC_F61A_4150_9277_E4E745C081FB
+#define PLATFORM_H_497F17CC_F61A_4150_9277_E4E745C081FB
+
+/**
+ * Compile-time platform selection.
+ *
+ * The library builds in two environments from the same sources:
+ *
+ * 	AVR		| the Arduino toolchain; avr-libc is available, the C++
+ * 			| standard library is not
+ * 	Host	| any hosted C++11 (or later) compiler, eg. a Linux gateway
+ *
+ * Exactly one of RADIOPACKET_PLATFORM_AVR and RADIOPACKET_PLATFORM_HOST is
+ * defined, along with exactly one of RADIOPACKET_LITTLE_ENDIAN and
+ * RADIOPACKET_BIG_ENDIAN. Define RADIOPACKET_NO_SIMD to build the host
+ * without instruction set specific paths.
+ */
+#if defined(__AVR__)
+	#define RADIOPACKET_PLATFORM_AVR
+#else
+	#define RADIOPACKET_PLATFORM_HOST
+#endif
+
+#if defined(__BYTE_ORDER__) && defined(__ORDER_LITTLE_ENDIAN__) && \
+	__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+	#define RADIOPACKET_LITTLE_ENDIAN
+#elif defined(__BYTE_ORDER__) && defined(__ORDER_BIG_ENDIAN__) && \
+	__BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	#define RADIOPACKET_BIG_ENDIAN
+#elif defined(_MSC_VER)
+	//every architecture MSVC targets is little-endian
+	#define RADIOPACKET_LITTLE_ENDIAN
+#else
+	#error "RadioPacket: unable to determine byte order"
+#endif
+
+//keeps data written by different threads on different cache lines; AVR
+//has no cache, and no RAM to spare for padding
+#if defined(RADIOPACKET_PLATFORM_HOST)
+	#define RADIOPACKET_CACHE_ALIGNED alignas(64)
+#else
+	#define RADIOPACKET_CACHE_ALIGNED
+#endif
+
+//keeps constant tables in flash on AVR, where they would otherwise be
+//copied to RAM at startup; read them back with memcpy_P
+#if defined(RADIOPACKET_PLATFORM_AVR)
+	#define RADIOPACKET_PROGMEM __attribute__((__progmem__))
+#else
+	#define RADIOPACKET_PROGMEM
+#endif
+
+//carry-less multiplication for CRCs; the CPU is still checked at runtime
+#if defined(RADIOPACKET_PLATFORM_HOST) && !defined(RADIOPACKET_NO_SIMD) && \
+	defined(__x86_64__) && defined(__GNUC__)
+	#define RADIOPACKET_CRC_CLMUL
+#endif
+
+//gathers and per-lane shifts for unpacking sample batches; the CPU is
+//still checked at runtime
+#if defined(RADIOPACKET_PLATFORM_HOST) && !defined(RADIOPACKET_NO_SIMD) && \
+	defined(__x86_64__) && defined(__GNUC__)
+	#define RADIOPACKET_SAMPLES_AVX2
+#endif
+
+#endif
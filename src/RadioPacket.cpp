@@ -22,28 +22,62 @@
 
 #include "RadioPacket.h"
 
-#include <math.h>
 #include <string.h>
+#include "Allocator.h"
+#include "Crc.h"
+#include "RadioPacketView.h"
 #include "Util.h"
 
 namespace RadioPacket {
 
 void RadioPacket::_init() noexcept {
+	this->_format = &PacketLayout<1>::FORMAT;
 	this->_data.clear();
 	this->_data.resize(RadioPacket::getHeaderLength(), false);
 	this->_data.copyFrom(RadioPacket::_DEFAULT_HEADER, RadioPacket::getHeaderLength());
+	this->_touch(true);
 }
 
-constexpr uint8_t RadioPacket::getMaxPacketLength() noexcept {
-	return 0xff;
+void RadioPacket::_copyFrom(const RadioPacketView& v) noexcept {
+	//header and body are contiguous, so copy both at once
+	this->_data.resize(v.getPacketLength(), false);
+	this->_data.copyFrom(v.getData(), v.getPacketLength());
+	this->_format = v.getFormat();
+	this->setRawPacketLength(v.getPacketLength());
+	this->_touch(true);
 }
 
-constexpr uint8_t RadioPacket::getHeaderLength() noexcept {
-	return _HEADER_LEN;
+void RadioPacket::_touch(const bool body) noexcept {
+	this->_crcDirty = true;
+	this->_checksumVerified = false;
+	if(body) {
+		this->_bodyCrcValid = false;
+	}
 }
 
-constexpr uint8_t RadioPacket::getMaxBodyLength() noexcept {
-	return RadioPacket::getMaxPacketLength() - RadioPacket::getHeaderLength();
+uint8_t RadioPacket::_bodyCrc() const noexcept {
+
+	if(!this->_bodyCrcValid) {
+		this->_bodyCrcCache = Crc8Ccitt::update(
+			0,
+			&this->_data[this->_format->headerLength],
+			this->getRawBodyLength());
+		this->_bodyCrcValid = true;
+	}
+
+	return this->_bodyCrcCache;
+
+}
+
+void RadioPacket::_updateChecksum() const noexcept {
+
+	if(!this->_autoChecksum || !this->_crcDirty) {
+		return;
+	}
+
+	this->_data[this->_format->crc8Offset] = this->generateChecksum();
+	this->_crcDirty = false;
+
 }
 
 RadioPacket::RadioPacket() noexcept {
@@ -55,115 +89,239 @@ RadioPacket::RadioPacket(const uint8_t* const body, const uint8_t len) noexcept
 		this->setBodyData(body, len);
 }
 
-RadioPacket::RadioPacket(const Message* msg) noexcept {
-	: RadioPacket(msg->getData(), msg->getMessageLength())
+RadioPacket::RadioPacket(const Message* msg) noexcept
+	: RadioPacket(msg->getData(), msg->getMessageLength()) {
 }
 
-RadioPacket::RadioPacket(const RadioPacket& p) noexcept {
+RadioPacket::RadioPacket(const RadioPacket& p) noexcept
+	:	_data(p._data),
+		_format(p._format),
+		_bodyCrcCache(p._bodyCrcCache),
+		_bodyCrcValid(p._bodyCrcValid),
+		_crcDirty(p._crcDirty),
+		_autoChecksum(p._autoChecksum),
+		_checksumVerified(p._checksumVerified) {
+}
+
+RadioPacket::RadioPacket(RadioPacket&& p) noexcept
+	:	_data(Util::move(p._data)),
+		_format(p._format),
+		_bodyCrcCache(p._bodyCrcCache),
+		_bodyCrcValid(p._bodyCrcValid),
+		_crcDirty(p._crcDirty),
+		_autoChecksum(p._autoChecksum),
+		_checksumVerified(p._checksumVerified) {
+}
+
+RadioPacket& RadioPacket::operator=(const RadioPacket& p) noexcept {
 	this->_data = p._data;
+	this->_format = p._format;
+	this->_bodyCrcCache = p._bodyCrcCache;
+	this->_bodyCrcValid = p._bodyCrcValid;
+	this->_crcDirty = p._crcDirty;
+	this->_autoChecksum = p._autoChecksum;
+	this->_checksumVerified = p._checksumVerified;
+	return *this;
+}
+
+RadioPacket& RadioPacket::operator=(RadioPacket&& p) noexcept {
+	this->_data = Util::move(p._data);
+	this->_format = p._format;
+	this->_bodyCrcCache = p._bodyCrcCache;
+	this->_bodyCrcValid = p._bodyCrcValid;
+	this->_crcDirty = p._crcDirty;
+	this->_autoChecksum = p._autoChecksum;
+	this->_checksumVerified = p._checksumVerified;
+	return *this;
 }
 
 void RadioPacket::setRawPacketLength(const uint8_t len) noexcept {
-	this->_data[0] = len;
+	this->_data[RadioPacket::_PACKETLEN_OFFSET] = len;
+	this->_touch();
 }
 
 void RadioPacket::setRawVersion(const uint8_t version) noexcept {
-	this->_data[1] = version;
+
+	const PacketFormat* const from = this->_format;
+	const PacketFormat* const to = KnownPacketLayouts::find(version);
+
+	if(to == nullptr || to == from) {
+		this->_data[RadioPacket::_VERSION_OFFSET] = version;
+		this->_touch();
+		return;
+	}
+
+	const uint8_t oldBodyLen = this->getRawBodyLength();
+	const uint8_t bodyLen = oldBodyLen > to->getMaxBodyLength()
+		? to->getMaxBodyLength()
+		: oldBodyLen;
+
+	uint8_t header[RadioPacket::_MAX_HEADER_LEN];
+	this->_data.copyTo(header, from->headerLength);
+
+	//slide the body along to follow the new header, then write the new
+	//header from the copy of the old one
+	if(to->headerLength > from->headerLength) {
+		this->_data.resize(to->headerLength + bodyLen, true);
+	}
+
+	::memmove(
+		&this->_data[to->headerLength],
+		&this->_data[from->headerLength],
+		bodyLen);
+
+	PacketFormat::convertHeader(*from, header, *to, &this->_data[0]);
+	this->_data.resize(to->headerLength + bodyLen, true);
+	this->_format = to;
+	this->_touch(bodyLen != oldBodyLen);
+
 }
 
-void RadioPacket::setRawTransmitterId(const uint16_t id) noexcept {
-	this->_data.setUInt16(id, 2);
+bool RadioPacket::setRawTransmitterId(const uint16_t id) noexcept {
+	const bool ok = this->_format->setAddress(&this->_data[this->_format->transmitterIdOffset], id);
+	this->_touch();
+	return ok;
 }
 
-void RadioPacket::setRawReceiverId(const uint16_t id) noexcept {
-	this->_data.setUInt16(id, 4);
+bool RadioPacket::setRawReceiverId(const uint16_t id) noexcept {
+	const bool ok = this->_format->setAddress(&this->_data[this->_format->receiverIdOffset], id);
+	this->_touch();
+	return ok;
 }
 
 void RadioPacket::setRawFragmentNumber(const uint8_t n) noexcept {
-	this->_data[6] = n;
+	this->_data[this->_format->fragmentOffset] = n;
+	this->_touch();
 }
 
 void RadioPacket::setRawBodyLength(const uint8_t len) noexcept {
-	this->_data[7] = len;
+	if(this->_format->hasBodyLength()) {
+		this->_data[this->_format->bodyLengthOffset] = len;
+	}
+	else {
+		this->_data[RadioPacket::_PACKETLEN_OFFSET] = this->_format->headerLength + len;
+	}
+	this->_touch(true);
+}
+
+void RadioPacket::setRawSequenceNumber(const uint16_t n) noexcept {
+	if(this->_format->hasSequenceNumber()) {
+		this->_data.setUInt16(n, this->_format->sequenceNumberOffset);
+		this->_touch();
+	}
+}
+
+void RadioPacket::setRawMessageId(const uint16_t id) noexcept {
+	if(this->_format->hasMessageId()) {
+		this->_data.setUInt16(id, this->_format->messageIdOffset);
+		this->_touch();
+	}
 }
 
 void RadioPacket::setRawCrc8(const uint8_t crc) noexcept {
-	this->_data[8] = crc;
+	this->_data[this->_format->crc8Offset] = crc;
+	//an explicit checksum stands until the packet next changes
+	this->_crcDirty = false;
+	this->_checksumVerified = false;
 }
 
 uint8_t RadioPacket::getRawPacketLength() const noexcept {
-	return this->_data[0];
+	return this->_data[RadioPacket::_PACKETLEN_OFFSET];
 }
 
 uint8_t RadioPacket::getRawVersion() const noexcept {
-	return this->_data[1];
+	return this->_data[RadioPacket::_VERSION_OFFSET];
 }
 
 uint16_t RadioPacket::getRawTransmitterId() const noexcept {
-	return this->_data.getUInt16(2);
+	return this->_format->getAddress(&this->_data[this->_format->transmitterIdOffset]);
 }
 
 uint16_t RadioPacket::getRawReceiverId() const noexcept {
-	return this->_data.getUInt16(4);
+	return this->_format->getAddress(&this->_data[this->_format->receiverIdOffset]);
 }
 
 uint8_t RadioPacket::getRawFragmentNumber() const noexcept {
-	return this->_data[6];
+	return this->_data[this->_format->fragmentOffset];
 }
 
 uint8_t RadioPacket::getRawBodyLength() const noexcept {
-	return this->_data[7];
+	return this->_format->getBodyLength(&this->_data[0]);
+}
+
+uint16_t RadioPacket::getRawSequenceNumber() const noexcept {
+	return this->_format->hasSequenceNumber()
+		? this->_data.getUInt16(this->_format->sequenceNumberOffset)
+		: 0;
+}
+
+uint16_t RadioPacket::getRawMessageId() const noexcept {
+	return this->_format->hasMessageId()
+		? this->_data.getUInt16(this->_format->messageIdOffset)
+		: 0;
 }
 
 uint8_t RadioPacket::getRawCrc8() const noexcept {
-	return this->_data[8];
+	this->_updateChecksum();
+	return this->_data[this->_format->crc8Offset];
+}
+
+const PacketFormat* RadioPacket::getFormat() const noexcept {
+	return this->_format;
 }
 
 const uint8_t* RadioPacket::getData() const noexcept {
+	this->_updateChecksum();
 	return &this->_data[0];
 }
 
 const uint8_t* RadioPacket::getHeaderData() const noexcept {
+	this->_updateChecksum();
 	return &this->_data[0];
 }
 
 const uint8_t* RadioPacket::getBodyData() const noexcept {
-	return &this->_data[RadioPacket::getHeaderLength()];
+	return &this->_data[this->_format->headerLength];
 }
 
 void RadioPacket::copyHeader(void* const data) const noexcept {
-	this->_data.copyTo(data, this->getHeaderLength(), RadioPacket::getHeaderLength());
+	this->_updateChecksum();
+	this->_data.copyTo(data, this->_format->headerLength);
 }
 
 void RadioPacket::copyBody(void* const data) const noexcept {
-	this->_data.copyToAt(data, this->getRawBodyLength())
+	this->_data.copyToAt(data, this->getRawBodyLength(), this->_format->headerLength);
 }
 
-void RadioPacket::setBodyData(const uint8_t* const data, const uint8_t len) {
+void RadioPacket::setBodyData(const uint8_t* const data, const uint8_t len) noexcept {
 	//resize the body, but don't bother copying the existing body
 	this->resizeBody(len, false);
-	this->_data.copyFromAt(data, len, RadioPacket::getHeaderLength());
+	this->_data.copyFromAt(data, len, this->_format->headerLength);
+	this->_touch(true);
 }
 
 void RadioPacket::resizeBody(const uint8_t bodyLen, const bool copy) noexcept {
 	
-	if(bodyLen > RadioPacket::getMaxBodyLength()) {
+	const uint8_t headerLen = this->_format->headerLength;
+
+	if(bodyLen > this->_format->getMaxBodyLength()) {
 		return;
 	}
 
 	if(!copy) {
-		uint8_t headerCopy[RadioPacket::getHeaderLength()];
-		this->_data.copyTo(headerCopy, RadioPacket::getHeaderLength());
-		this->_data.resize(RadioPacket::getHeaderLength() + bodyLen, false);
-		this->_data.copyFrom(headerCopy, RadioPacket::getHeaderLength());
+		uint8_t headerCopy[RadioPacket::_MAX_HEADER_LEN];
+		this->_data.copyTo(headerCopy, headerLen);
+		this->_data.resize(headerLen + bodyLen, false);
+		this->_data.copyFrom(headerCopy, headerLen);
 	}
 	else {
-		this->_data.resize(RadioPacket::getHeaderLength() + bodyLen, true);
+		this->_data.resize(headerLen + bodyLen, true);
 	}
 
 	//set new length
-	this->setRawPacketLength(RadioPacket::getHeaderLength() + bodyLen);
+	this->setRawPacketLength(headerLen + bodyLen);
 	this->setRawBodyLength(bodyLen);
+	this->_touch(true);
 
 }
 
@@ -184,22 +342,32 @@ Message* RadioPacket::getMessage() const noexcept {
 
 uint8_t RadioPacket::generateChecksum() const noexcept {
 	
-	uint8_t crc = Util::crc8(0, nullptr, 0);
-
 	//calculate the crc for the header (without the crc)
-	crc = Util::crc8(
+	//read _data directly; getHeaderData may call back into here
+	const uint8_t crc = Crc8Ccitt::update(
+		Crc8Ccitt::init(),
+		&this->_data[0],
+		this->_format->headerLength - sizeof(uint8_t));
+
+	//append the cached crc for the body
+	return Crc8Ccitt::finalize(Crc8Ccitt::combine(
 		crc,
-		this->getHeaderData(),
-		this->getHeaderLength() - sizeof(uint8_t));
+		this->_bodyCrc(),
+		this->getRawBodyLength()));
 
-	//calculate the crc for the body
-	crc = Util::crc8(
-		crc,
-		this->getBodyData(),
-		this->getRawBodyLength());
+}
 
-	return crc;
+void RadioPacket::setAutoChecksum(const bool enable) noexcept {
+	this->_autoChecksum = enable;
+	this->_crcDirty = true;
+}
+
+bool RadioPacket::getAutoChecksum() const noexcept {
+	return this->_autoChecksum;
+}
 
+bool RadioPacket::isChecksumVerified() const noexcept {
+	return this->_checksumVerified;
 }
 
 void RadioPacket::reset() noexcept {
@@ -208,42 +376,63 @@ void RadioPacket::reset() noexcept {
 
 uint8_t RadioPacket::parse(RadioPacket** const p, const uint8_t* const buff, const uint16_t len) noexcept {
 
-	if(len < RadioPacket::getHeaderLength()) {
-		return RadioPacket::PARSE_ERROR_INCOMPLETE_HEADER;
+	//validate in place before allocating anything
+	RadioPacketView v;
+	const uint8_t result = RadioPacketView::parse(&v, buff, len);
+
+	if(result != RadioPacket::PARSE_OK) {
+		return result;
 	}
 
 	*p = new RadioPacket;
-	
-	//copy the header first
-	(*p)->_data.copyFrom(buff, RadioPacket::getHeaderLength());
 
-	//make sure there are sufficient bytes in the buffer before copying
-	if((*p)->getRawBodyLength() > (len - RadioPacket::getHeaderLength())) {
-		delete *p;
-		return RadioPacket::PARSE_ERROR_INSUFFICIENT_BYTES;
+	if(*p == nullptr) {
+		return RadioPacket::PARSE_ERROR_OUT_OF_MEMORY;
 	}
 
-	//check if the body length exceeds the maximum permitted
-	if((*p)->getRawBodyLength() > RadioPacket::getMaxBodyLength()) {
-		delete *p;
-		return RadioPacket::PARSE_ERROR_MAX_LENGTH_EXCEEDED;
-	}
-
-	//copy of the rest based on the body length in the header
-	(*p)->setBodyData(
-		buff + RadioPacket::getHeaderLength(),
-		(*p)->getRawBodyLength());
+	(*p)->_copyFrom(v);
+	(*p)->_checksumVerified = (*p)->generateChecksum() == v.getRawCrc8();
 
 	return RadioPacket::PARSE_OK;
 
 }
 
-uint8_t RadioPacket::calculateFragmentNumber(const uint16_t len) {
-	const double maxBodyLenDbl = static_cast<double>(RadioPacket::getMaxBodyLength());
-	return ceil(len / maxBodyLenDbl);
+uint8_t RadioPacket::parse(
+	PoolHandle<RadioPacket>* const p,
+	Pool<RadioPacket>& pool,
+	const uint8_t* const buff,
+	const uint16_t len) noexcept {
+
+		//validate in place before drawing from the pool
+		RadioPacketView v;
+		const uint8_t result = RadioPacketView::parse(&v, buff, len);
+
+		if(result != RadioPacket::PARSE_OK) {
+			return result;
+		}
+
+		//return any object already held by the handle before drawing
+		//a new one, so a handle can be reused with a pool of one
+		p->reset();
+		*p = pool.acquire();
+
+		if(!*p) {
+			return RadioPacket::PARSE_ERROR_POOL_EXHAUSTED;
+		}
+
+		(*p)->_copyFrom(v);
+		(*p)->_checksumVerified = (*p)->generateChecksum() == v.getRawCrc8();
+
+		return RadioPacket::PARSE_OK;
+
 }
 
-uint8_t RadioPacket::fragment2(RadioPacket** packets, const uint8_t* const data, const uint16_t len) {
+uint8_t RadioPacket::calculateFragmentNumber(const uint16_t len) noexcept {
+	//integer ceiling; avoids pulling in floating point
+	return (len + RadioPacket::getMaxBodyLength() - 1) / RadioPacket::getMaxBodyLength();
+}
+
+uint8_t RadioPacket::fragment2(RadioPacket** packets, const uint8_t* const data, const uint16_t len) noexcept {
 
 	RadioPacket* p = nullptr;
 	const uint16_t fragments = RadioPacket::calculateFragmentNumber(len);
@@ -252,6 +441,10 @@ uint8_t RadioPacket::fragment2(RadioPacket** packets, const uint8_t* const data,
 
 		p = new RadioPacket;
 
+		if(p == nullptr) {
+			return f;
+		}
+
 		p->setRawFragmentNumber(f);
 		p->setBodyData(
 			data + (f * RadioPacket::getMaxBodyLength()),
@@ -265,7 +458,7 @@ uint8_t RadioPacket::fragment2(RadioPacket** packets, const uint8_t* const data,
 
 }
 
-uint8_t RadioPacket::fragment(RadioPacket** packets, const uint8_t* const data, const uint16_t len) {
+uint8_t RadioPacket::fragment(RadioPacket** packets, const uint8_t* const data, const uint16_t len) noexcept {
 
 	RadioPacket* p = nullptr;
 	uint8_t fragmentNumber = 0;
@@ -275,6 +468,10 @@ uint8_t RadioPacket::fragment(RadioPacket** packets, const uint8_t* const data,
 
 		p = new RadioPacket;
 
+		if(p == nullptr) {
+			break;
+		}
+
 		p->setRawFragmentNumber(fragmentNumber);
 		p->setBodyData(
 			data + (bytesPacketised - RadioPacket::getMaxBodyLength()),
@@ -291,7 +488,7 @@ uint8_t RadioPacket::fragment(RadioPacket** packets, const uint8_t* const data,
 
 }
 
-uint16_t RadioPacket::defragment(RadioPacket** packets, const uint8_t packetsLen, uint8_t* const data) {
+uint16_t RadioPacket::defragment(RadioPacket** packets, const uint8_t packetsLen, uint8_t* const data) noexcept {
 
 	uint16_t byteOffset = 0;
 
@@ -307,12 +504,25 @@ uint16_t RadioPacket::defragment(RadioPacket** packets, const uint8_t packetsLen
 	}
 
 	//return the number of bytes defragmented
-	return byteOffset + 1;
+	return byteOffset;
 
 }
 
+void* RadioPacket::operator new(const size_t size) noexcept {
+	return RADIOPACKET_ALLOCATOR(RadioPacket)::allocate(size);
+}
+
+void* RadioPacket::operator new(const size_t, void* const ptr) noexcept {
+	return ptr;
+}
+
+void RadioPacket::operator delete(void* const ptr, const size_t size) noexcept {
+	RADIOPACKET_ALLOCATOR(RadioPacket)::deallocate(ptr, size);
+}
+
+void RadioPacket::operator delete(void* const, void* const) noexcept {
+}
+
 constexpr uint8_t RadioPacket::_DEFAULT_HEADER[];
 
 };
-
-#endif
@@ -23,10 +23,13 @@
 #ifndef RADIO_PACKET_H_D3C3A8BD_BB6E_46A5_A992_9286C892C492
 #define RADIO_PACKET_H_D3C3A8BD_BB6E_46A5_A992_9286C892C492
 
+#include <stddef.h>
 #include <stdint.h>
 
 #include "NetworkBuffer.h"
 #include "Message.h"
+#include "ObjectPool.h"
+#include "PacketLayout.h"
 
 /** 
  * A RadioPacket is limited in length to 0xff, which is the maximum
@@ -36,23 +39,30 @@
  * Therefore, the maximum body length of a RadioPacket will always
  * be <= 0xff - header length.
  * 
- * Formatted as such:
- * 
- * 	HEADER	| 0x0 - 0x0				[ PACKET LENGTH, 1 byte, unsigned ]
- * 			| 0x1 - 0x1				[ VERSION, 1 byte, unsigned ]
- * 			| 0x2 - 0x3				[ TRANSMITTER ID, 2 bytes, unsigned ]
- * 			| 0x4 - 0x5				[ RECEIVER ID, 2 bytes, unsigned ]
- * 			| 0x6 - 0x6				[ FRAGMENT, 1 byte, unsigned ]
- * 			| 0x7 - 0x7				[ BODY LENGTH, 1 byte, unsigned ]
- * 			| 0x8 - 0x8				[ CRC8, 1 byte, unsigned ]
- * 	BODY	| 0x9 - {BODY LENGTH-1}	[ BODY DATA ]
+ * The header is versioned; see PacketLayout.h for the layout of each
+ * version. New packets use version 1 unless setRawVersion selects
+ * another, and parsing accepts any version in KnownPacketLayouts.
  */
 namespace RadioPacket {
+
+class PacketEncoder;
+class RadioPacketView;
+
+template<size_t N>
+class PacketBatch;
+
+template<size_t Capacity>
+class StreamDeframer;
+
 class RadioPacket {
 
 protected:
 
-	static const uint8_t _HEADER_LEN = 9;
+	static const uint8_t _MAX_PACKET_LEN = 0xff;
+	static const uint8_t _HEADER_LEN = PacketLayout<1>::HEADER_LEN;
+	static const uint8_t _MAX_HEADER_LEN = KnownPacketLayouts::getMaxHeaderLength();
+	static const uint8_t _PACKETLEN_OFFSET = 0x0;
+	static const uint8_t _VERSION_OFFSET = 0x1;
 
 	/**
 	 * Stored in network byte order (MSB first)
@@ -71,7 +81,57 @@ protected:
 	
 	void _init() noexcept;
 
-	NetworkBuffer<uint8_t, uint8_t> _data;
+	/**
+	 * Copy an already-validated packet's header and body into this packet
+	 */
+	void _copyFrom(const RadioPacketView& v) noexcept;
+
+	/**
+	 * Mark the checksum as out of date after the header changes; the body
+	 * CRC is only discarded if body is true
+	 */
+	void _touch(const bool body = false) noexcept;
+
+	/**
+	 * CRC register over the body, starting from zero; cached so that a
+	 * header change does not rescan the body
+	 */
+	uint8_t _bodyCrc() const noexcept;
+
+	/**
+	 * Write a fresh checksum into the header if auto-checksum is enabled
+	 * and the packet has changed since it was last written
+	 */
+	void _updateChecksum() const noexcept;
+
+	/**
+	 * A packet can never exceed _MAX_PACKET_LEN bytes, so it is held
+	 * inline and never touches the heap
+	 *
+	 * Mutable so that an auto-checksum can be written when the data is
+	 * read
+	 */
+	mutable NetworkBuffer<uint8_t, uint8_t, InlineStorage<_MAX_PACKET_LEN>> _data;
+
+	/**
+	 * Layout of the header, selected by its version
+	 */
+	const PacketFormat* _format = &PacketLayout<1>::FORMAT;
+
+	mutable uint8_t _bodyCrcCache = 0;
+	mutable bool _bodyCrcValid = false;
+	mutable bool _crcDirty = false;
+	bool _autoChecksum = false;
+	bool _checksumVerified = false;
+
+	friend class PacketEncoder;
+	friend class RadioPacketView;
+
+	template<size_t N>
+	friend class PacketBatch;
+
+	template<size_t Capacity>
+	friend class StreamDeframer;
 
 
 public:
@@ -80,23 +140,88 @@ public:
 	static const uint8_t PARSE_ERROR_INCOMPLETE_HEADER = 1;
 	static const uint8_t PARSE_ERROR_INSUFFICIENT_BYTES = 2;
 	static const uint8_t PARSE_ERROR_MAX_LENGTH_EXCEEDED = 3;
+	static const uint8_t PARSE_ERROR_POOL_EXHAUSTED = 4;
+	static const uint8_t PARSE_ERROR_OUT_OF_MEMORY = 5;
+	static const uint8_t PARSE_ERROR_UNKNOWN_VERSION = 6;
 
-	static constexpr uint8_t getMaxPacketLength() noexcept;
-	static constexpr uint8_t getHeaderLength() noexcept;
-	static constexpr uint8_t getMaxBodyLength() noexcept;
+	static constexpr uint8_t getMaxPacketLength() noexcept {
+		return _MAX_PACKET_LEN;
+	}
+
+	/**
+	 * Length of a version 1 header; a packet's own header length is
+	 * getFormat()->headerLength
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getHeaderLength() noexcept {
+		return _HEADER_LEN;
+	}
+
+	/**
+	 * Largest body a version 1 packet can carry; a packet's own limit is
+	 * getFormat()->getMaxBodyLength()
+	 * @return {uint8_t}  :
+	 */
+	static constexpr uint8_t getMaxBodyLength() noexcept {
+		return getMaxPacketLength() - getHeaderLength();
+	}
 
 	RadioPacket() noexcept;
 	RadioPacket(const uint8_t* const body, const uint8_t len) noexcept;
 	RadioPacket(const Message* msg) noexcept;
 	RadioPacket(const RadioPacket& p) noexcept;
+	RadioPacket(RadioPacket&& p) noexcept;
+	RadioPacket& operator=(const RadioPacket& p) noexcept;
+	RadioPacket& operator=(RadioPacket&& p) noexcept;
 	virtual ~RadioPacket() = default;
 
+	/**
+	 * Packets created with new are allocated through
+	 * RADIOPACKET_ALLOCATOR(RadioPacket), and new yields nullptr rather
+	 * than throwing if the allocator fails
+	 */
+	static void* operator new(const size_t size) noexcept;
+	static void* operator new(const size_t size, void* const ptr) noexcept;
+	static void operator delete(void* const ptr, const size_t size) noexcept;
+	static void operator delete(void* const ptr, void* const) noexcept;
+
 	void setRawPacketLength(const uint8_t len) noexcept;
+
+	/**
+	 * Set the version. If the version has a known layout which differs
+	 * from the current one, the header is converted to it and the body is
+	 * moved to follow it (see PacketFormat::convertHeader); the body is
+	 * truncated if the new header leaves too little room. Any other
+	 * version is written as-is and the current layout is kept.
+	 * @param  {uint8_t} version :
+	 */
 	void setRawVersion(const uint8_t version) noexcept;
-	void setRawTransmitterId(const uint16_t id) noexcept;
-	void setRawReceiverId(const uint16_t id) noexcept;
+
+	/**
+	 * Set the transmitter or receiver ID. A version 3 packet carries a
+	 * short address from an AddressMap, or PacketFormat::BROADCAST_ID;
+	 * a larger value is written as PacketFormat::UNASSIGNED_ADDRESS and
+	 * false is returned.
+	 * @param  {uint16_t} id :
+	 * @return {bool}        :
+	 */
+	bool setRawTransmitterId(const uint16_t id) noexcept;
+	bool setRawReceiverId(const uint16_t id) noexcept;
 	void setRawFragmentNumber(const uint8_t n) noexcept;
 	void setRawBodyLength(const uint8_t len) noexcept;
+
+	/**
+	 * Ignored if the packet's version has no sequence number
+	 * @param  {uint16_t} n :
+	 */
+	void setRawSequenceNumber(const uint16_t n) noexcept;
+
+	/**
+	 * Ignored if the packet's version has no message ID
+	 * @param  {uint16_t} id :
+	 */
+	void setRawMessageId(const uint16_t id) noexcept;
+
 	void setRawCrc8(const uint8_t crc) noexcept;
 
 	uint8_t getRawPacketLength() const noexcept;
@@ -105,16 +230,37 @@ public:
 	uint16_t getRawReceiverId() const noexcept;
 	uint8_t getRawFragmentNumber() const noexcept;
 	uint8_t getRawBodyLength() const noexcept;
+
+	/**
+	 * 0 if the packet's version has no sequence number
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getRawSequenceNumber() const noexcept;
+
+	/**
+	 * 0 if the packet's version has no message ID
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getRawMessageId() const noexcept;
+
 	uint8_t getRawCrc8() const noexcept;
 
+	/**
+	 * Layout of this packet's header
+	 * @return {PacketFormat*}  :
+	 */
+	const PacketFormat* getFormat() const noexcept;
+
 	/**
 	 * Returns a pointer to this packet's entire data
+	 * If auto-checksum is enabled, the checksum is brought up to date first
 	 * @return {uint8_t*}  : 
 	 */
 	const uint8_t* getData() const noexcept;
 
 	/**
 	 * Returns a pointer to this packet's header data
+	 * If auto-checksum is enabled, the checksum is brought up to date first
 	 * @return {uint8_t*}  : 
 	 */
 	const uint8_t* getHeaderData() const noexcept;
@@ -166,9 +312,34 @@ public:
 	/**
 	 * Generate a CRC8 checksum across the packet.
 	 * This calculation EXCLUDES the CRC value in the header
+	 * The body's CRC is cached, so after the first call only the header
+	 * is rescanned until the body changes
 	 * @return {uint8_t}  : 
 	 */
 	uint8_t generateChecksum() const noexcept;
+
+	/**
+	 * When enabled, the setters mark the checksum out of date and it is
+	 * regenerated once, when the packet's data, header or CRC is next read.
+	 * There is then no need to call setRawCrc8(generateChecksum()).
+	 * Disabled by default.
+	 * @param  {bool} enable : 
+	 */
+	void setAutoChecksum(const bool enable) noexcept;
+
+	/**
+	 * Whether auto-checksum is enabled
+	 * @return {bool}  : 
+	 */
+	bool getAutoChecksum() const noexcept;
+
+	/**
+	 * Returns true if this packet was parsed with a correct checksum and
+	 * has not been changed since; receivers need not generate the checksum
+	 * again
+	 * @return {bool}  : 
+	 */
+	bool isChecksumVerified() const noexcept;
 		
 	/**
 	 * Resets this packet to default header data with no body
@@ -177,7 +348,8 @@ public:
 
 	/**
 	 * Parse arbitrary bytes into a packet. Returns RadioPacket::PARSE_OK
-	 * on success.
+	 * on success. The checksum is verified as the packet is parsed; see
+	 * isChecksumVerified.
 	 * @param  {RadioPacket**} const : pointer to pointer to RadioPacket
 	 * @param  {uint8_t*} const      : array of bytes
 	 * @param  {uint16_t} len        : length of byte array
@@ -187,11 +359,35 @@ public:
 		RadioPacket** const p,
 		const uint8_t* const buff,
 		const uint16_t len) noexcept;
+
+	/**
+	 * Parse arbitrary bytes into a packet drawn from pool. Nothing is
+	 * allocated; the packet is returned to pool when p is reset or
+	 * destroyed. Returns RadioPacket::PARSE_OK on success. The checksum
+	 * is verified as the packet is parsed; see isChecksumVerified.
+	 * @param  {PoolHandle<RadioPacket>*} const : handle to hold the packet
+	 * @param  {Pool<RadioPacket>&} pool        : pool to draw the packet from
+	 * @param  {uint8_t*} const                 : array of bytes
+	 * @param  {uint16_t} len                   : length of byte array
+	 * @return {uint8_t}                        : one of the RadioPacket::PARSE_* constants
+	 */
+	static uint8_t parse(
+		PoolHandle<RadioPacket>* const p,
+		Pool<RadioPacket>& pool,
+		const uint8_t* const buff,
+		const uint16_t len) noexcept;
 	
 	/**
-	 * Fragmentation functions are bugged; do not use
+	 * Number of packets needed to carry len bytes
+	 * @param  {uint16_t} len :
+	 * @return {uint8_t}      :
 	 */
 	static uint8_t calculateFragmentNumber(const uint16_t len) noexcept;
+
+	/**
+	 * Fragmentation functions are bugged; do not use
+	 * Use a Fragmenter and Reassembler instead, which need no allocation
+	 */
 	static uint8_t fragment2(RadioPacket** packets, const uint8_t* const data, const uint16_t len) noexcept;
 	static uint8_t fragment(RadioPacket** packets, const uint8_t* const data, const uint16_t len) noexcept;
 	static uint16_t defragment(RadioPacket** packets, const uint8_t packetsLen, uint8_t* const data) noexcept;
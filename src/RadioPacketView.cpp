@@ -0,0 +1,188 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#include "RadioPacketView.h"
+
+#include <string.h>
+#include "Util.h"
+
+namespace RadioPacket {
+
+RadioPacketView::RadioPacketView() noexcept {
+}
+
+bool RadioPacketView::isValid() const noexcept {
+	return this->_data != nullptr;
+}
+
+uint8_t RadioPacketView::getRawPacketLength() const noexcept {
+	return this->_data[RadioPacket::_PACKETLEN_OFFSET];
+}
+
+uint8_t RadioPacketView::getRawVersion() const noexcept {
+	return this->_data[RadioPacket::_VERSION_OFFSET];
+}
+
+uint16_t RadioPacketView::getRawTransmitterId() const noexcept {
+	return this->_format->getAddress(&this->_data[this->_format->transmitterIdOffset]);
+}
+
+uint16_t RadioPacketView::getRawReceiverId() const noexcept {
+	return this->_format->getAddress(&this->_data[this->_format->receiverIdOffset]);
+}
+
+uint8_t RadioPacketView::getRawFragmentNumber() const noexcept {
+	return this->_data[this->_format->fragmentOffset];
+}
+
+uint8_t RadioPacketView::getRawBodyLength() const noexcept {
+	return this->_format->getBodyLength(this->_data);
+}
+
+uint16_t RadioPacketView::getRawSequenceNumber() const noexcept {
+
+	if(!this->_format->hasSequenceNumber()) {
+		return 0;
+	}
+
+	uint16_t netuint;
+	::memcpy(&netuint, &this->_data[this->_format->sequenceNumberOffset], sizeof(uint16_t));
+	return (Util::ntohs)(netuint);
+
+}
+
+uint16_t RadioPacketView::getRawMessageId() const noexcept {
+
+	if(!this->_format->hasMessageId()) {
+		return 0;
+	}
+
+	uint16_t netuint;
+	::memcpy(&netuint, &this->_data[this->_format->messageIdOffset], sizeof(uint16_t));
+	return (Util::ntohs)(netuint);
+
+}
+
+uint8_t RadioPacketView::getRawCrc8() const noexcept {
+	return this->_data[this->_format->crc8Offset];
+}
+
+const PacketFormat* RadioPacketView::getFormat() const noexcept {
+	return this->_format;
+}
+
+uint8_t RadioPacketView::getHeaderLength() const noexcept {
+	return this->_format->headerLength;
+}
+
+uint8_t RadioPacketView::getPacketLength() const noexcept {
+	return this->getHeaderLength() + this->getRawBodyLength();
+}
+
+const uint8_t* RadioPacketView::getData() const noexcept {
+	return this->_data;
+}
+
+const uint8_t* RadioPacketView::getHeaderData() const noexcept {
+	return this->_data;
+}
+
+const uint8_t* RadioPacketView::getBodyData() const noexcept {
+	return this->_data + this->getHeaderLength();
+}
+
+uint8_t RadioPacketView::generateChecksum() const noexcept {
+
+	uint8_t crc = Util::crc8(0, nullptr, 0);
+
+	//calculate the crc for the header (without the crc)
+	crc = Util::crc8(
+		crc,
+		this->getHeaderData(),
+		this->getHeaderLength() - sizeof(uint8_t));
+
+	//calculate the crc for the body
+	crc = Util::crc8(
+		crc,
+		this->getBodyData(),
+		this->getRawBodyLength());
+
+	return crc;
+
+}
+
+uint8_t RadioPacketView::getMessage(MessageView* const m) const noexcept {
+	return MessageView::parse(
+		m,
+		this->getBodyData(),
+		this->getRawBodyLength());
+}
+
+template<class Layout>
+uint8_t RadioPacketView::LayoutParser::visit() const noexcept {
+
+	if(this->len < Layout::HEADER_LEN) {
+		return RadioPacket::PARSE_ERROR_INCOMPLETE_HEADER;
+	}
+
+	//without a body length field, the packet length must cover the header
+	if(Layout::BODYLEN_OFFSET == 0 && this->buff[Layout::PACKETLEN_OFFSET] < Layout::HEADER_LEN) {
+		return RadioPacket::PARSE_ERROR_INCOMPLETE_HEADER;
+	}
+
+	const uint8_t bodyLen = PacketHeader<Layout>::getBodyLength(this->buff);
+
+	//make sure there are sufficient bytes in the buffer for the body
+	if(bodyLen > (this->len - Layout::HEADER_LEN)) {
+		return RadioPacket::PARSE_ERROR_INSUFFICIENT_BYTES;
+	}
+
+	//check if the body length exceeds the maximum permitted
+	if(bodyLen > Layout::MAX_BODY_LEN) {
+		return RadioPacket::PARSE_ERROR_MAX_LENGTH_EXCEEDED;
+	}
+
+	this->view->_data = this->buff;
+	this->view->_format = &Layout::FORMAT;
+
+	return RadioPacket::PARSE_OK;
+
+}
+
+uint8_t RadioPacketView::LayoutParser::unknown() const noexcept {
+	return RadioPacket::PARSE_ERROR_UNKNOWN_VERSION;
+}
+
+uint8_t RadioPacketView::parse(RadioPacketView* const v, const uint8_t* const buff, const uint16_t len) noexcept {
+
+	//the version decides how long the header is
+	if(len <= RadioPacket::_VERSION_OFFSET) {
+		return RadioPacket::PARSE_ERROR_INCOMPLETE_HEADER;
+	}
+
+	const LayoutParser parser = { v, buff, len };
+
+	return KnownPacketLayouts::dispatch(buff[RadioPacket::_VERSION_OFFSET], parser);
+
+}
+
+};
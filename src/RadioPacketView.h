@@ -0,0 +1,172 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef RADIO_PACKET_VIEW_H_A05AF747_329B_49C7_B3D7_01DEE77355D7
+#define RADIO_PACKET_VIEW_H_A05AF747_329B_49C7_B3D7_01DEE77355D7
+
+#include <stdint.h>
+
+#include "MessageView.h"
+#include "RadioPacket.h"
+
+/**
+ * A RadioPacketView is a non-owning, read-only window over a packet
+ * held in a caller's buffer (eg. the Manchester receive buffer).
+ *
+ * Nothing is allocated or copied; every field is read straight from
+ * the underlying bytes, so the buffer must outlive the view and must
+ * not be modified while the view is in use.
+ *
+ * The format is the same as RadioPacket. parse dispatches on the version
+ * byte to a validator instantiated for each layout in KnownPacketLayouts,
+ * and the view then reads fields through the layout it found.
+ */
+namespace RadioPacket {
+class RadioPacketView {
+
+protected:
+
+	const uint8_t* _data = nullptr;
+	const PacketFormat* _format = nullptr;
+
+	/**
+	 * Validates buff against the layout of its version; see
+	 * PacketLayouts::dispatch
+	 */
+	struct LayoutParser {
+
+		RadioPacketView* const view;
+		const uint8_t* const buff;
+		const uint16_t len;
+
+		template<class Layout>
+		uint8_t visit() const noexcept;
+
+		uint8_t unknown() const noexcept;
+
+	};
+
+
+public:
+
+	RadioPacketView() noexcept;
+	RadioPacketView(const RadioPacketView& v) noexcept = default;
+	RadioPacketView& operator=(const RadioPacketView& v) noexcept = default;
+
+	/**
+	 * Whether this view refers to a parsed packet
+	 * @return {bool}  :
+	 */
+	bool isValid() const noexcept;
+
+	uint8_t getRawPacketLength() const noexcept;
+	uint8_t getRawVersion() const noexcept;
+	uint16_t getRawTransmitterId() const noexcept;
+	uint16_t getRawReceiverId() const noexcept;
+	uint8_t getRawFragmentNumber() const noexcept;
+	uint8_t getRawBodyLength() const noexcept;
+
+	/**
+	 * 0 if the packet's version has no sequence number
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getRawSequenceNumber() const noexcept;
+
+	/**
+	 * 0 if the packet's version has no message ID
+	 * @return {uint16_t}  :
+	 */
+	uint16_t getRawMessageId() const noexcept;
+
+	uint8_t getRawCrc8() const noexcept;
+
+	/**
+	 * Layout of the packet's header
+	 * @return {PacketFormat*}  :
+	 */
+	const PacketFormat* getFormat() const noexcept;
+
+	/**
+	 * Returns the length of the packet's header, which depends on its
+	 * version
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getHeaderLength() const noexcept;
+
+	/**
+	 * Returns the number of bytes the packet occupies in the buffer
+	 * (ie. header length + body length)
+	 * @return {uint8_t}  :
+	 */
+	uint8_t getPacketLength() const noexcept;
+
+	/**
+	 * Returns a pointer to the packet's entire data
+	 * @return {uint8_t*}  :
+	 */
+	const uint8_t* getData() const noexcept;
+
+	/**
+	 * Returns a pointer to the packet's header data
+	 * @return {uint8_t*}  :
+	 */
+	const uint8_t* getHeaderData() const noexcept;
+
+	/**
+	 * Returns a pointer to the packet's body data
+	 * @return {uint8_t*}  :
+	 */
+	const uint8_t* getBodyData() const noexcept;
+
+	/**
+	 * Generate a CRC8 checksum across the packet.
+	 * This calculation EXCLUDES the CRC value in the header
+	 * @return {uint8_t}  :
+	 */
+	uint8_t generateChecksum() const noexcept;
+
+	/**
+	 * Point m at the Message held in this packet's body. Returns
+	 * Message::PARSE_OK on success.
+	 * @param  {MessageView*} const :
+	 * @return {uint8_t}            : one of the Message::PARSE_* constants
+	 */
+	uint8_t getMessage(MessageView* const m) const noexcept;
+
+	/**
+	 * Validate arbitrary bytes as a packet and point v at them. Returns
+	 * RadioPacket::PARSE_OK on success, in which case v remains valid for
+	 * as long as buff does.
+	 * @param  {RadioPacketView*} const :
+	 * @param  {uint8_t*} const         : array of bytes
+	 * @param  {uint16_t} len           : length of byte array
+	 * @return {uint8_t}                : one of the RadioPacket::PARSE_* constants
+	 */
+	static uint8_t parse(
+		RadioPacketView* const v,
+		const uint8_t* const buff,
+		const uint16_t len) noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,622 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef REASSEMBLER_H_7778DE17_FD55_4D8C_948D_FD89DC55F127
+#define REASSEMBLER_H_7778DE17_FD55_4D8C_948D_FD89DC55F127
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Fragmenter.h"
+#include "Message.h"
+#include "MessageView.h"
+#include "RadioPacket.h"
+#include "RadioPacketView.h"
+#include "Util.h"
+
+/**
+ * A Reassembler collects the fragments produced by a Fragmenter back into
+ * complete Messages.
+ *
+ * Fragments may arrive in any order and may be duplicated. Up to Slots
+ * messages are reassembled concurrently. Version 1 and 3 fragments carry
+ * no message ID, so there is one message per transmitter; version 2
+ * fragments are kept apart by their message ID, so a transmitter may have
+ * several messages in flight. Each slot
+ * holds up to MaxMessageLength bytes and a bitmap of the fragments it has
+ * received, so the memory used is fixed at compile time no matter how
+ * many transmitters are heard from.
+ *
+ * A fragment for a message with no slot takes a free slot, or else
+ * the slot of a message which has not been added to for longer than the
+ * timeout, or else the least recently used slot.
+ *
+ * Each body byte is copied once, from the packet into its slot. A
+ * message which fits in a single fragment is not copied at all.
+ *
+ * With Parity, each slot also holds a Fragmenter's parity fragment, and
+ * a message missing one fragment is rebuilt from it rather than lost. A
+ * parity fragment is only used for a message already being reassembled;
+ * one for a message which is complete is reported as a duplicate.
+ *
+ * A fragment which differs from one already received for the same
+ * message, or which contradicts the others, starts the message again, as
+ * it must belong to a later message. Without a message ID, that is the
+ * next message from the same transmitter. A later message's parity
+ * fragment likewise abandons the message.
+ *
+ * 	Reassembler<4, 1024> r;
+ * 	MessageView m;
+ *
+ * 	if(r.accept(p, ::millis(), &m) == r.ACCEPT_COMPLETE) {
+ * 		//use m
+ * 	}
+ */
+namespace RadioPacket {
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity = false>
+class Reassembler {
+
+	static_assert(Slots > 0, "Reassembler must have at least one slot");
+	static_assert(MaxMessageLength >= Message::getHeaderLength(),
+		"Reassembler slots must hold at least a Message header");
+	static_assert(MaxMessageLength <= static_cast<uint16_t>(0xff) * RadioPacket::getMaxBodyLength(),
+		"Reassembler slots cannot hold more than 255 fragments");
+
+protected:
+
+	/**
+	 * Fragments carry the least data with the longest header
+	 */
+	static const uint8_t _MIN_FRAGMENT_LEN =
+		RadioPacket::getMaxPacketLength() - KnownPacketLayouts::getMaxHeaderLength();
+
+	/**
+	 * Fragments carry the most data with the shortest header
+	 */
+	static const uint8_t _MAX_FRAGMENT_LEN =
+		RadioPacket::getMaxPacketLength() - KnownPacketLayouts::getMinHeaderLength();
+
+	static const uint16_t _FRAGMENTS_NEEDED =
+		(MaxMessageLength + _MIN_FRAGMENT_LEN - 1) / _MIN_FRAGMENT_LEN;
+
+	static const uint8_t _MAX_FRAGMENTS = static_cast<uint8_t>(
+		_FRAGMENTS_NEEDED > 0xff ? 0xff : _FRAGMENTS_NEEDED);
+
+	static const uint8_t _BITMAP_LEN = (_MAX_FRAGMENTS + 7) / 8;
+
+	static_assert(!Parity || _MAX_FRAGMENTS < Fragmenter::PARITY_FRAGMENT_NUMBER,
+		"Reassembler slots with parity cannot hold more than 254 fragments");
+
+	struct Slot {
+		uint8_t data[MaxMessageLength];
+		uint8_t parity[Parity ? _MAX_FRAGMENT_LEN : 1];
+		uint8_t received[_BITMAP_LEN];
+		uint32_t lastSeen;
+		uint16_t transmitterId;
+		uint16_t messageId;
+		uint8_t version;
+		uint8_t fragmentLength;		//data carried by all but the last fragment
+		uint16_t length;			//total length; 0 until known
+		uint8_t fragmentCount;		//0 until known
+		uint8_t receivedCount;
+		uint8_t lastFragment;		//highest fragment number received
+		bool hasParity;
+		bool inUse;
+	};
+
+	Slot _slots[Slots];
+	uint32_t _timeout = 5000;
+
+	static inline uint16_t _offsetOf(const Slot& s, const uint8_t fragment) noexcept {
+		return static_cast<uint16_t>(fragment - 1) * s.fragmentLength;
+	}
+
+	void _clear(Slot& s) noexcept {
+		s.inUse = false;
+		s.length = 0;
+		s.fragmentCount = 0;
+		s.receivedCount = 0;
+		s.lastFragment = 0;
+		s.hasParity = false;
+		::memset(s.received, 0, _BITMAP_LEN);
+	}
+
+	static inline bool _hasFragment(const Slot& s, const uint8_t fragment) noexcept {
+		return (s.received[(fragment - 1) >> 3] & (1 << ((fragment - 1) & 7))) != 0;
+	}
+
+	/**
+	 * Body length of a fragment received into s
+	 */
+	static inline uint8_t _lengthOf(const Slot& s, const uint8_t fragment) noexcept {
+		return s.length != 0 && fragment == s.fragmentCount
+			? static_cast<uint8_t>(s.length - _offsetOf(s, fragment))
+			: s.fragmentLength;
+	}
+
+	/**
+	 * Find the slot for p's message, if it has one
+	 */
+	Slot* _findSlot(const RadioPacketView& p) noexcept {
+
+		for(size_t i = 0; i < Slots; ++i) {
+
+			Slot& s = this->_slots[i];
+
+			if(s.inUse &&
+				s.transmitterId == p.getRawTransmitterId() &&
+				s.messageId == p.getRawMessageId() &&
+				s.version == p.getRawVersion()) {
+					return &s;
+			}
+
+		}
+
+		return nullptr;
+
+	}
+
+	/**
+	 * Find the slot for p's message, claiming one if there is none
+	 */
+	Slot& _slotFor(const RadioPacketView& p, const uint32_t now) noexcept {
+
+		const uint16_t transmitterId = p.getRawTransmitterId();
+		const uint16_t messageId = p.getRawMessageId();
+		const uint8_t version = p.getRawVersion();
+
+		Slot* freeSlot = nullptr;
+		Slot* lru = nullptr;
+
+		for(size_t i = 0; i < Slots; ++i) {
+
+			Slot& s = this->_slots[i];
+
+			if(!s.inUse) {
+				if(freeSlot == nullptr) {
+					freeSlot = &s;
+				}
+				continue;
+			}
+
+			if(s.transmitterId == transmitterId &&
+				s.messageId == messageId &&
+				s.version == version) {
+					return s;
+			}
+
+			if(now - s.lastSeen > this->_timeout && freeSlot == nullptr) {
+				freeSlot = &s;
+			}
+
+			//unsigned subtraction copes with the clock wrapping around
+			if(lru == nullptr || now - s.lastSeen > now - lru->lastSeen) {
+				lru = &s;
+			}
+
+		}
+
+		Slot& s = freeSlot != nullptr ? *freeSlot : *lru;
+
+		this->_clear(s);
+		s.inUse = true;
+		s.transmitterId = transmitterId;
+		s.messageId = messageId;
+		s.version = version;
+		s.fragmentLength = p.getFormat()->getMaxBodyLength();
+
+		return s;
+
+	}
+
+	/**
+	 * Empty s, keeping it for the same message key
+	 */
+	void _restart(Slot& s) noexcept {
+		this->_clear(s);
+		s.inUse = true;
+	}
+
+	/**
+	 * Record the total length once a fragment reveals it; returns false if
+	 * it conflicts with what is already known or cannot be held
+	 */
+	bool _learnLength(Slot& s, const uint16_t length) noexcept {
+
+		if(length > MaxMessageLength || length < Message::getHeaderLength()) {
+			return false;
+		}
+
+		if(s.length != 0) {
+			return s.length == length;
+		}
+
+		s.length = length;
+		s.fragmentCount = static_cast<uint8_t>(
+			(length + s.fragmentLength - 1) / s.fragmentLength);
+
+		return true;
+
+	}
+
+	/**
+	 * Rebuild the one fragment s is missing from its parity fragment, if
+	 * it has both. Until the length is known, the count of fragments is
+	 * taken to be the highest received; only the first fragment, which
+	 * holds the length, can then be missing, and the length it holds
+	 * must agree.
+	 */
+	void _recover(Slot& s) noexcept {
+
+		const uint8_t count = s.fragmentCount != 0 ? s.fragmentCount : s.lastFragment;
+
+		if(!s.hasParity || s.receivedCount + 1 != count) {
+			return;
+		}
+
+		uint8_t missing = 1;
+
+		while(_hasFragment(s, missing)) {
+			++missing;
+		}
+
+		if(s.fragmentCount == 0 && missing != 1) {
+			return;
+		}
+
+		const uint16_t offset = _offsetOf(s, missing);
+		const uint8_t len = _lengthOf(s, missing);
+		uint8_t* const out = s.data + offset;
+
+		if(offset + len > MaxMessageLength) {
+			return;
+		}
+
+		//a short missing fragment was padded with zeros, so the parity
+		//past its end must cancel out; if not, the parity is for another
+		//message
+		for(uint8_t i = len; i < s.fragmentLength; ++i) {
+
+			uint8_t padding = s.parity[i];
+
+			for(uint8_t f = 1; f <= count; ++f) {
+				if(f != missing && i < _lengthOf(s, f)) {
+					padding ^= s.data[_offsetOf(s, f) + i];
+				}
+			}
+
+			if(padding != 0) {
+				s.hasParity = false;
+				return;
+			}
+
+		}
+
+		::memcpy(out, s.parity, len);
+
+		for(uint8_t f = 1; f <= count; ++f) {
+
+			if(f == missing) {
+				continue;
+			}
+
+			const uint8_t* const in = s.data + _offsetOf(s, f);
+			const uint8_t n = _lengthOf(s, f) < len ? _lengthOf(s, f) : len;
+
+			for(uint8_t i = 0; i < n; ++i) {
+				out[i] ^= in[i];
+			}
+
+		}
+
+		if(s.fragmentCount == 0) {
+
+			uint16_t msgBodyLen;
+			::memcpy(&msgBodyLen, out, sizeof(uint16_t));
+			const uint16_t length = Message::getHeaderLength() + (Util::ntohs)(msgBodyLen);
+
+			//every fragment received is full, or the length would be known
+			if(length != static_cast<uint16_t>(count) * s.fragmentLength ||
+				!this->_learnLength(s, length)) {
+					return;
+			}
+
+		}
+
+		s.received[(missing - 1) >> 3] |= static_cast<uint8_t>(1 << ((missing - 1) & 7));
+		++s.receivedCount;
+
+	}
+
+	/**
+	 * Return whether s is complete, pointing m at its message if it is
+	 */
+	uint8_t _complete(Slot& s, MessageView* const m) noexcept {
+
+		if(Parity) {
+			this->_recover(s);
+		}
+
+		if(s.fragmentCount == 0 || s.receivedCount < s.fragmentCount) {
+			return ACCEPT_INCOMPLETE;
+		}
+
+		//the slot is freed, but its data is left in place until it is
+		//next claimed
+		s.inUse = false;
+
+		return MessageView::parse(m, s.data, s.length) == Message::PARSE_OK
+			? ACCEPT_COMPLETE
+			: ACCEPT_ERROR_INVALID_FRAGMENT;
+
+	}
+
+	uint8_t _acceptParity(const RadioPacketView& p, const uint32_t now, MessageView* const m) noexcept {
+
+		Slot* const s = this->_findSlot(p);
+
+		if(s == nullptr) {
+			return ACCEPT_DUPLICATE;
+		}
+
+		if(p.getRawBodyLength() != s->fragmentLength) {
+			return ACCEPT_ERROR_INVALID_FRAGMENT;
+		}
+
+		//a different parity fragment belongs to a later message with the
+		//same key, so the message in s will not be completed
+		if(s->hasParity) {
+			if(::memcmp(s->parity, p.getBodyData(), s->fragmentLength) != 0) {
+				this->_clear(*s);
+			}
+			return ACCEPT_DUPLICATE;
+		}
+
+		::memcpy(s->parity, p.getBodyData(), s->fragmentLength);
+		s->hasParity = true;
+		s->lastSeen = now;
+
+		return this->_complete(*s, m);
+
+	}
+
+	uint8_t _accept(const RadioPacketView& p, const uint32_t now, MessageView* const m) noexcept {
+
+		const uint8_t fragment = p.getRawFragmentNumber();
+		const uint8_t bodyLen = p.getRawBodyLength();
+		const uint8_t* const body = p.getBodyData();
+		const uint8_t maxBodyLen = p.getFormat()->getMaxBodyLength();
+
+		if(Parity && fragment == Fragmenter::PARITY_FRAGMENT_NUMBER) {
+			return this->_acceptParity(p, now, m);
+		}
+
+		if(fragment == 0 || fragment > _MAX_FRAGMENTS) {
+			return ACCEPT_ERROR_INVALID_FRAGMENT;
+		}
+
+		//a message in a single fragment is used in place
+		if(fragment == 1 && bodyLen < maxBodyLen) {
+			return MessageView::parse(m, body, bodyLen) == Message::PARSE_OK &&
+				m->getMessageLength() == bodyLen
+					? ACCEPT_COMPLETE
+					: ACCEPT_ERROR_INVALID_FRAGMENT;
+		}
+
+		Slot& s = this->_slotFor(p, now);
+		s.lastSeen = now;
+
+		const uint8_t bit = static_cast<uint8_t>(1 << ((fragment - 1) & 7));
+		uint8_t& bits = s.received[(fragment - 1) >> 3];
+
+		//a fragment which differs from the one received, like one which
+		//contradicts the others, belongs to a later message with the same
+		//key; without a message ID, that is any later message from the
+		//same transmitter
+		if(bits & bit) {
+
+			if(bodyLen == _lengthOf(s, fragment) &&
+				::memcmp(s.data + _offsetOf(s, fragment), body, bodyLen) == 0) {
+					return ACCEPT_DUPLICATE;
+			}
+
+			this->_restart(s);
+
+			return this->_accept(p, now, m);
+
+		}
+
+		//the first fragment begins with the Message header, which holds
+		//the total length; a short fragment must be the last
+		bool valid = true;
+
+		if(fragment == 1 && bodyLen >= Message::getHeaderLength()) {
+			uint16_t msgBodyLen;
+			::memcpy(&msgBodyLen, body, sizeof(uint16_t));
+			valid = this->_learnLength(s, Message::getHeaderLength() + (Util::ntohs)(msgBodyLen));
+		}
+		else if(bodyLen < maxBodyLen) {
+			valid = this->_learnLength(s, _offsetOf(s, fragment) + bodyLen);
+		}
+
+		if(valid && s.length != 0) {
+			valid = fragment <= s.fragmentCount && (fragment == s.fragmentCount
+				? _offsetOf(s, fragment) + bodyLen == s.length
+				: bodyLen == maxBodyLen);
+		}
+
+		if(!valid || _offsetOf(s, fragment) + bodyLen > MaxMessageLength) {
+
+			if(s.receivedCount == 0) {
+				this->_clear(s);
+				return ACCEPT_ERROR_INVALID_FRAGMENT;
+			}
+
+			this->_restart(s);
+
+			return this->_accept(p, now, m);
+
+		}
+
+		::memcpy(s.data + _offsetOf(s, fragment), body, bodyLen);
+		bits |= bit;
+		++s.receivedCount;
+
+		if(fragment > s.lastFragment) {
+			s.lastFragment = fragment;
+		}
+
+		return this->_complete(s, m);
+
+	}
+
+
+public:
+
+	static const uint8_t ACCEPT_INCOMPLETE = 0;
+	static const uint8_t ACCEPT_COMPLETE = 1;
+	static const uint8_t ACCEPT_DUPLICATE = 2;
+	static const uint8_t ACCEPT_ERROR_INVALID_FRAGMENT = 3;
+	static const uint8_t ACCEPT_ERROR_CHECKSUM = 4;
+
+	Reassembler() noexcept {
+		for(size_t i = 0; i < Slots; ++i) {
+			this->_clear(this->_slots[i]);
+			this->_slots[i].lastSeen = 0;
+			this->_slots[i].transmitterId = 0;
+			this->_slots[i].messageId = 0;
+			this->_slots[i].version = 0;
+			this->_slots[i].fragmentLength = RadioPacket::getMaxBodyLength();
+		}
+	}
+
+	Reassembler(const Reassembler& r) = delete;
+	Reassembler& operator=(const Reassembler& r) = delete;
+
+	/**
+	 * Time, in the same units as now, after which an incomplete message
+	 * may be evicted. Defaults to 5000 (ie. 5s of millis()).
+	 * @param  {uint32_t} timeout :
+	 */
+	void setTimeout(const uint32_t timeout) noexcept {
+		this->_timeout = timeout;
+	}
+
+	/**
+	 * Add a fragment. When it completes a message, returns ACCEPT_COMPLETE
+	 * and points m at the message. m then refers to either p's buffer or
+	 * a slot, so it is valid until p's buffer changes or accept is next
+	 * called, whichever is sooner.
+	 * @param  {RadioPacketView} p  : fragment
+	 * @param  {uint32_t} now       : current time, eg. millis()
+	 * @param  {MessageView*} const :
+	 * @return {uint8_t}            : one of the ACCEPT_* constants
+	 */
+	uint8_t accept(const RadioPacketView& p, const uint32_t now, MessageView* const m) noexcept {
+
+		if(!p.isValid()) {
+			return ACCEPT_ERROR_INVALID_FRAGMENT;
+		}
+
+		if(p.generateChecksum() != p.getRawCrc8()) {
+			return ACCEPT_ERROR_CHECKSUM;
+		}
+
+		return this->_accept(p, now, m);
+
+	}
+
+	/**
+	 * As above; the checksum is not regenerated if it was verified when p
+	 * was parsed
+	 * @param  {RadioPacket} p      : fragment
+	 * @param  {uint32_t} now       : current time, eg. millis()
+	 * @param  {MessageView*} const :
+	 * @return {uint8_t}            : one of the ACCEPT_* constants
+	 */
+	uint8_t accept(const RadioPacket& p, const uint32_t now, MessageView* const m) noexcept {
+
+		RadioPacketView v;
+
+		if(RadioPacketView::parse(&v, p.getData(), p.getRawPacketLength()) != RadioPacket::PARSE_OK) {
+			return ACCEPT_ERROR_INVALID_FRAGMENT;
+		}
+
+		if(!p.isChecksumVerified() && p.generateChecksum() != p.getRawCrc8()) {
+			return ACCEPT_ERROR_CHECKSUM;
+		}
+
+		return this->_accept(v, now, m);
+
+	}
+
+	/**
+	 * Abandon incomplete messages not added to within the timeout
+	 * @param  {uint32_t} now : current time, eg. millis()
+	 */
+	void expire(const uint32_t now) noexcept {
+		for(size_t i = 0; i < Slots; ++i) {
+			if(this->_slots[i].inUse && now - this->_slots[i].lastSeen > this->_timeout) {
+				this->_clear(this->_slots[i]);
+			}
+		}
+	}
+
+	/**
+	 * Number of messages currently being reassembled
+	 * @return {size_t}  :
+	 */
+	size_t inUse() const noexcept {
+
+		size_t n = 0;
+
+		for(size_t i = 0; i < Slots; ++i) {
+			n += this->_slots[i].inUse ? 1 : 0;
+		}
+
+		return n;
+
+	}
+
+};
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity>
+const uint8_t Reassembler<Slots, MaxMessageLength, Parity>::ACCEPT_INCOMPLETE;
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity>
+const uint8_t Reassembler<Slots, MaxMessageLength, Parity>::ACCEPT_COMPLETE;
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity>
+const uint8_t Reassembler<Slots, MaxMessageLength, Parity>::ACCEPT_DUPLICATE;
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity>
+const uint8_t Reassembler<Slots, MaxMessageLength, Parity>::ACCEPT_ERROR_INVALID_FRAGMENT;
+
+template<size_t Slots, uint16_t MaxMessageLength, bool Parity>
+const uint8_t Reassembler<Slots, MaxMessageLength, Parity>::ACCEPT_ERROR_CHECKSUM;
+
+};
+
+#endif
@@ -0,0 +1,396 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "ReedSolomon.h"
+
+#include <string.h>
+
+#include "Meta.h"
+
+namespace RadioPacket {
+
+#if defined(RADIOPACKET_PLATFORM_HOST)
+
+/**
+ * Compile-time field arithmetic for generating the tables
+ */
+struct GaloisMath {
+
+	/**
+	 * a * x mod 0x11d
+	 */
+	static constexpr uint8_t xtime(const uint8_t a) noexcept {
+		return static_cast<uint8_t>((a << 1) ^ ((a & 0x80) ? 0x1d : 0));
+	}
+
+	static constexpr uint8_t multiply(const uint8_t a, const uint8_t b) noexcept {
+		return b == 0
+			? 0
+			: static_cast<uint8_t>(((b & 1) ? a : 0) ^ multiply(xtime(a), b >> 1));
+	}
+
+	/**
+	 * a^n, by squaring
+	 */
+	static constexpr uint8_t power(const uint8_t a, const unsigned n) noexcept {
+		return n == 0
+			? 1
+			: multiply((n & 1) ? a : 1, power(multiply(a, a), n >> 1));
+	}
+
+	static constexpr uint8_t exp(const size_t i) noexcept {
+		return power(2, static_cast<unsigned>(i % 255));
+	}
+
+	/**
+	 * i such that a^i == x, searching from a^i == p; 0 for 0
+	 */
+	static constexpr uint8_t log(const uint8_t x, const unsigned i = 0, const uint8_t p = 1) noexcept {
+		return i == 255
+			? 0
+			: p == x ? static_cast<uint8_t>(i) : log(x, i + 1, xtime(p));
+	}
+
+};
+
+struct GaloisTables {
+
+	/**
+	 * Twice around the field, so that the sum of two logs needs no
+	 * reduction
+	 */
+	uint8_t exp[512];
+	uint8_t log[256];
+
+	template<size_t... I>
+	static constexpr GaloisTables generate(Meta::IndexSequence<I...>) noexcept {
+		return GaloisTables{
+			{ GaloisMath::exp(I)..., GaloisMath::exp(I + 256)... },
+			{ GaloisMath::log(static_cast<uint8_t>(I))... }
+		};
+	}
+
+};
+
+static constexpr GaloisTables GALOIS = GaloisTables::generate(
+	Meta::MakeIndexSequence<256>::Type());
+
+inline uint8_t ReedSolomon::_multiply(const uint8_t a, const uint8_t b) noexcept {
+	return a == 0 || b == 0
+		? 0
+		: GALOIS.exp[GALOIS.log[a] + GALOIS.log[b]];
+}
+
+inline uint8_t ReedSolomon::_inverse(const uint8_t a) noexcept {
+	return GALOIS.exp[255 - GALOIS.log[a]];
+}
+
+#else
+
+inline uint8_t ReedSolomon::_multiply(uint8_t a, uint8_t b) noexcept {
+
+	uint8_t r = 0;
+
+	while(b != 0) {
+		if(b & 1) {
+			r ^= a;
+		}
+		a = static_cast<uint8_t>((a << 1) ^ ((a & 0x80) ? 0x1d : 0));
+		b >>= 1;
+	}
+
+	return r;
+
+}
+
+uint8_t ReedSolomon::_inverse(const uint8_t a) noexcept {
+
+	//a^254, by squaring
+	uint8_t r = 1;
+	uint8_t p = a;
+
+	for(uint8_t n = 254; n != 0; n >>= 1) {
+		if(n & 1) {
+			r = _multiply(r, p);
+		}
+		p = _multiply(p, p);
+	}
+
+	return r;
+
+}
+
+#endif
+
+ReedSolomon::ReedSolomon() {
+}
+
+void ReedSolomon::_generator(uint8_t* const g, const uint8_t parityLength) noexcept {
+
+	uint8_t root = 1;
+
+	g[0] = 1;
+	::memset(g + 1, 0, parityLength);
+
+	//multiply by (x + a^i) for each root
+	for(uint8_t i = 0; i < parityLength; ++i) {
+		for(uint8_t k = i + 1; k > 0; --k) {
+			g[k] ^= _multiply(g[k - 1], root);
+		}
+		root = _multiply(root, 2);
+	}
+
+}
+
+void ReedSolomon::encode(
+	const uint8_t* const data,
+	const uint8_t len,
+	uint8_t* const parity,
+	const uint8_t parityLength,
+	const uint8_t stride) noexcept {
+
+		if(parityLength == 0 || parityLength > MAX_PARITY_LENGTH ||
+			static_cast<uint16_t>(len) + parityLength > 0xff) {
+				return;
+		}
+
+		uint8_t g[MAX_PARITY_LENGTH + 1];
+		uint8_t r[MAX_PARITY_LENGTH];
+
+		_generator(g, parityLength);
+		::memset(r, 0, parityLength);
+
+		//the remainder of data * x^parityLength divided by g, shifted
+		//through r highest degree first
+		for(uint8_t j = 0; j < len; ++j) {
+
+			const uint8_t feedback = data[static_cast<size_t>(j) * stride] ^ r[0];
+
+			for(uint8_t k = 0; k + 1 < parityLength; ++k) {
+				r[k] = r[k + 1] ^ _multiply(feedback, g[k + 1]);
+			}
+
+			r[parityLength - 1] = _multiply(feedback, g[parityLength]);
+
+		}
+
+		for(uint8_t k = 0; k < parityLength; ++k) {
+			parity[static_cast<size_t>(k) * stride] = r[k];
+		}
+
+}
+
+uint8_t ReedSolomon::decode(
+	uint8_t* const data,
+	const uint8_t len,
+	uint8_t* const parity,
+	const uint8_t parityLength,
+	const uint8_t stride,
+	uint8_t* const corrected) noexcept {
+
+		if(corrected != nullptr) {
+			*corrected = 0;
+		}
+
+		if(parityLength == 0 || parityLength > MAX_PARITY_LENGTH ||
+			static_cast<uint16_t>(len) + parityLength > 0xff) {
+				return DECODE_ERROR_INVALID_LENGTH;
+		}
+
+		const uint8_t n = len + parityLength;
+
+		uint8_t syndromes[MAX_PARITY_LENGTH];
+		uint8_t roots[MAX_PARITY_LENGTH];
+		uint8_t root = 1;
+
+		for(uint8_t i = 0; i < parityLength; ++i) {
+			syndromes[i] = 0;
+			roots[i] = root;
+			root = _multiply(root, 2);
+		}
+
+		//S(i) is the codeword evaluated at a^i, by Horner's rule from the
+		//highest degree (the first data byte) down; each byte is read
+		//once, and the syndromes do not depend on each other
+		for(uint8_t j = 0; j < n; ++j) {
+
+			const uint8_t c = j < len
+				? data[static_cast<size_t>(j) * stride]
+				: parity[static_cast<size_t>(j - len) * stride];
+
+			for(uint8_t i = 0; i < parityLength; ++i) {
+				syndromes[i] = _multiply(syndromes[i], roots[i]) ^ c;
+			}
+
+		}
+
+		bool clean = true;
+
+		for(uint8_t i = 0; i < parityLength; ++i) {
+			clean = clean && syndromes[i] == 0;
+		}
+
+		if(clean) {
+			return DECODE_OK;
+		}
+
+		//Berlekamp-Massey for the error locator, lowest degree first
+		uint8_t locator[MAX_PARITY_LENGTH + 1];
+		uint8_t previous[MAX_PARITY_LENGTH + 1];
+		uint8_t saved[MAX_PARITY_LENGTH + 1];
+		uint8_t errors = 0;
+		uint8_t shift = 1;
+		uint8_t previousDiscrepancy = 1;
+
+		::memset(locator, 0, parityLength + 1);
+		::memset(previous, 0, parityLength + 1);
+		locator[0] = 1;
+		previous[0] = 1;
+
+		for(uint8_t k = 0; k < parityLength; ++k) {
+
+			uint8_t discrepancy = syndromes[k];
+
+			for(uint8_t i = 1; i <= errors; ++i) {
+				discrepancy ^= _multiply(locator[i], syndromes[k - i]);
+			}
+
+			if(discrepancy == 0) {
+				++shift;
+				continue;
+			}
+
+			const uint8_t scale = _multiply(discrepancy, _inverse(previousDiscrepancy));
+			const bool grow = 2 * errors <= k;
+
+			if(grow) {
+				::memcpy(saved, locator, parityLength + 1);
+			}
+
+			for(uint8_t i = shift; i <= parityLength; ++i) {
+				locator[i] ^= _multiply(scale, previous[i - shift]);
+			}
+
+			if(grow) {
+				errors = k + 1 - errors;
+				::memcpy(previous, saved, parityLength + 1);
+				previousDiscrepancy = discrepancy;
+				shift = 1;
+			}
+			else {
+				++shift;
+			}
+
+		}
+
+		if(2 * errors > parityLength) {
+			return DECODE_ERROR_UNCORRECTABLE;
+		}
+
+		//error evaluator, S(x) * locator(x) mod x^errors
+		uint8_t evaluator[MAX_PARITY_LENGTH / 2];
+
+		for(uint8_t k = 0; k < errors; ++k) {
+			evaluator[k] = 0;
+			for(uint8_t i = 0; i <= k; ++i) {
+				evaluator[k] ^= _multiply(syndromes[k - i], locator[i]);
+			}
+		}
+
+		//Chien search over the degrees in the codeword, with Forney's
+		//formula for each error found; as the first root is a^0, the
+		//magnitude is evaluator(X^-1) over the odd terms of locator(X^-1).
+		//Term i of locator(X^-1) is multiplied by a^-i to step from one
+		//degree to the next.
+		uint8_t terms[MAX_PARITY_LENGTH / 2 + 1];
+		uint8_t steps[MAX_PARITY_LENGTH / 2 + 1];
+		uint8_t positions[MAX_PARITY_LENGTH / 2];
+		uint8_t magnitudes[MAX_PARITY_LENGTH / 2];
+		uint8_t found = 0;
+		uint8_t xInverse = 1;
+
+		for(uint8_t i = 0, step = 1; i <= errors; ++i) {
+			terms[i] = locator[i];
+			steps[i] = step;
+			step = _multiply(step, _ALPHA_INVERSE);
+		}
+
+		for(uint8_t degree = 0; degree < n; ++degree) {
+
+			uint8_t value = 0;
+			uint8_t odd = 0;
+
+			for(uint8_t i = 0; i <= errors; ++i) {
+				value ^= terms[i];
+				odd ^= (i & 1) ? terms[i] : 0;
+				terms[i] = _multiply(terms[i], steps[i]);
+			}
+
+			if(value == 0) {
+
+				if(found == errors || odd == 0) {
+					return DECODE_ERROR_UNCORRECTABLE;
+				}
+
+				uint8_t e = 0;
+				uint8_t power = 1;
+
+				for(uint8_t k = 0; k < errors; ++k) {
+					e ^= _multiply(evaluator[k], power);
+					power = _multiply(power, xInverse);
+				}
+
+				positions[found] = n - 1 - degree;
+				magnitudes[found] = _multiply(e, _inverse(odd));
+				++found;
+
+			}
+
+			xInverse = _multiply(xInverse, _ALPHA_INVERSE);
+
+		}
+
+		//a root for every error, or the errors lie outside the codeword
+		if(found != errors) {
+			return DECODE_ERROR_UNCORRECTABLE;
+		}
+
+		for(uint8_t k = 0; k < found; ++k) {
+			const uint8_t j = positions[k];
+			if(j < len) {
+				data[static_cast<size_t>(j) * stride] ^= magnitudes[k];
+			}
+			else {
+				parity[static_cast<size_t>(j - len) * stride] ^= magnitudes[k];
+			}
+		}
+
+		if(corrected != nullptr) {
+			*corrected = found;
+		}
+
+		return DECODE_OK;
+
+}
+
+};
@@ -0,0 +1,132 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+
+#ifndef REED_SOLOMON_H_8F4736D2_8F13_47D2_BD78_B0862A8B4943
+#define REED_SOLOMON_H_8F4736D2_8F13_47D2_BD78_B0862A8B4943
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Platform.h"
+
+/**
+ * Systematic Reed-Solomon coding over GF(2^8), with the field polynomial
+ * x^8 + x^4 + x^3 + x^2 + 1 (0x11d) and generator roots a^0 to
+ * a^(parityLength - 1).
+ *
+ * A codeword is up to 255 bytes: len bytes of data followed by
+ * parityLength bytes of parity. Codes shorter than 255 bytes are
+ * shortened codes; the missing data bytes are taken to be 0 and are
+ * never sent. Up to parityLength / 2 corrupted bytes anywhere in the
+ * codeword, parity included, are corrected.
+ *
+ * Data and parity bytes are addressed with a stride, so that several
+ * codewords interleaved in one buffer are coded in place (see FecCodec).
+ *
+ * Backends are selected at compile time:
+ *
+ * 	AVR		| bitwise multiplication; no tables, so no RAM is spent
+ * 			| on them
+ * 	Host	| log and antilog tables generated at compile time
+ */
+namespace RadioPacket {
+
+class ReedSolomon {
+
+protected:
+
+	/**
+	 * a^-1
+	 */
+	static const uint8_t _ALPHA_INVERSE = 0x8e;
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	ReedSolomon();
+
+	static uint8_t _multiply(const uint8_t a, const uint8_t b) noexcept;
+
+	/**
+	 * a must not be 0
+	 */
+	static uint8_t _inverse(const uint8_t a) noexcept;
+
+	/**
+	 * Generator polynomial, highest degree first; g has parityLength + 1
+	 * coefficients, the first of which is 1
+	 */
+	static void _generator(uint8_t* const g, const uint8_t parityLength) noexcept;
+
+
+public:
+
+	static const uint8_t MAX_PARITY_LENGTH = 32;
+
+	static const uint8_t DECODE_OK = 0;
+	static const uint8_t DECODE_ERROR_UNCORRECTABLE = 1;
+	static const uint8_t DECODE_ERROR_INVALID_LENGTH = 2;
+
+	/**
+	 * Calculate the parity of len bytes of data, each stride bytes apart,
+	 * and write it to parity, stride bytes apart. Nothing is written if
+	 * parityLength is 0 or above MAX_PARITY_LENGTH, or if len +
+	 * parityLength exceeds 255.
+	 * @param  {uint8_t*} const      : data
+	 * @param  {uint8_t} len         : number of data bytes
+	 * @param  {uint8_t*} const      : parity
+	 * @param  {uint8_t} parityLength : number of parity bytes
+	 * @param  {uint8_t} stride      : distance between bytes
+	 */
+	static void encode(
+		const uint8_t* const data,
+		const uint8_t len,
+		uint8_t* const parity,
+		const uint8_t parityLength,
+		const uint8_t stride = 1) noexcept;
+
+	/**
+	 * Correct a codeword in place. A codeword with no errors is
+	 * identified from its syndromes alone, which is the common case.
+	 * If the errors cannot be corrected, the codeword is left as it was.
+	 * @param  {uint8_t*} const       : data
+	 * @param  {uint8_t} len          : number of data bytes
+	 * @param  {uint8_t*} const       : parity
+	 * @param  {uint8_t} parityLength : number of parity bytes
+	 * @param  {uint8_t} stride       : distance between bytes
+	 * @param  {uint8_t*} corrected   : set to the number of bytes corrected; may be nullptr
+	 * @return {uint8_t}              : one of the DECODE_* constants
+	 */
+	static uint8_t decode(
+		uint8_t* const data,
+		const uint8_t len,
+		uint8_t* const parity,
+		const uint8_t parityLength,
+		const uint8_t stride = 1,
+		uint8_t* const corrected = nullptr) noexcept;
+
+};
+};
+
+#endif
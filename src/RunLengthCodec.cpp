@@ -0,0 +1,177 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "RunLengthCodec.h"
+
+#include <string.h>
+
+namespace RadioPacket {
+
+RunLengthEncoder::RunLengthEncoder() {
+}
+
+size_t RunLengthEncoder::encode(
+	const uint8_t* const in,
+	const size_t len,
+	uint8_t* const out,
+	const size_t capacity) noexcept {
+
+		size_t i = 0;
+		size_t o = 0;
+		size_t literal = 0;		//start of the pending literal
+		size_t literalLen = 0;
+
+		while(i <= len) {
+
+			size_t run = 1;
+
+			if(i < len) {
+				while(i + run < len && run < _MAX_RUN && in[i + run] == in[i]) {
+					++run;
+				}
+			}
+
+			//flush the pending literal before a repeat, at the end, or
+			//once it can grow no longer
+			if(literalLen > 0 && (i == len || run >= _MIN_REPEAT || literalLen == _MAX_RUN)) {
+
+				if(o + 1 + literalLen > capacity) {
+					return 0;
+				}
+
+				out[o++] = static_cast<uint8_t>(literalLen - 1);
+				::memcpy(out + o, in + literal, literalLen);
+				o += literalLen;
+				literalLen = 0;
+
+			}
+
+			if(i == len) {
+				break;
+			}
+
+			if(run >= _MIN_REPEAT) {
+
+				if(o + 2 > capacity) {
+					return 0;
+				}
+
+				out[o++] = static_cast<uint8_t>(257 - run);
+				out[o++] = in[i];
+				i += run;
+
+			}
+			else {
+
+				if(literalLen == 0) {
+					literal = i;
+				}
+
+				++literalLen;
+				++i;
+
+			}
+
+		}
+
+		return o;
+
+}
+
+RunLengthDecoder::RunLengthDecoder() noexcept {
+}
+
+void RunLengthDecoder::reset() noexcept {
+	this->_remaining = 0;
+	this->_repeating = false;
+	this->_awaitingRepeat = false;
+}
+
+size_t RunLengthDecoder::decode(
+	const uint8_t* const in,
+	const size_t len,
+	size_t* const consumed,
+	uint8_t* const out,
+	const size_t capacity) noexcept {
+
+		size_t i = 0;
+		size_t o = 0;
+
+		while(o < capacity) {
+
+			if(this->_remaining > 0 && !this->_awaitingRepeat) {
+
+				const size_t space = capacity - o;
+				size_t n = this->_remaining < space ? this->_remaining : space;
+
+				if(this->_repeating) {
+					::memset(out + o, this->_repeat, n);
+				}
+				else {
+					n = n < len - i ? n : len - i;
+					::memcpy(out + o, in + i, n);
+					i += n;
+				}
+
+				o += n;
+				this->_remaining -= static_cast<uint8_t>(n);
+
+				if(n == 0) {
+					break;
+				}
+
+				continue;
+
+			}
+
+			if(i == len) {
+				break;
+			}
+
+			if(this->_awaitingRepeat) {
+				this->_repeat = in[i++];
+				this->_awaitingRepeat = false;
+				continue;
+			}
+
+			const uint8_t n = in[i++];
+
+			if(n < 128) {
+				this->_remaining = n + 1;
+				this->_repeating = false;
+			}
+			else if(n > 128) {
+				this->_remaining = static_cast<uint8_t>(257 - n);
+				this->_repeating = true;
+				this->_awaitingRepeat = true;
+			}
+
+		}
+
+		*consumed = i;
+
+		return o;
+
+}
+
+};
@@ -0,0 +1,128 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef RUN_LENGTH_CODEC_H_52446778_AE22_4FE0_991A_A27BFF97B2FC
+#define RUN_LENGTH_CODEC_H_52446778_AE22_4FE0_991A_A27BFF97B2FC
+
+#include <stddef.h>
+#include <stdint.h>
+
+/**
+ * Run-length coding in the PackBits format. Data is a sequence of runs,
+ * each introduced by a control byte n:
+ *
+ * 	0 - 127		| the next n + 1 bytes are copied as they are
+ * 	129 - 255	| the next byte is repeated 257 - n times
+ * 	128			| ignored
+ *
+ * Readings which change slowly or sit at a rail (eg. zeroed padding, a
+ * saturated sensor) shrink well; data with no runs grows by at most one
+ * byte in 128.
+ *
+ * Neither side keeps any history, so encoding needs no RAM beyond the
+ * output and decoding can stop and resume at any byte.
+ */
+namespace RadioPacket {
+
+class RunLengthEncoder {
+
+protected:
+
+	static const uint8_t _MAX_RUN = 128;
+
+	/**
+	 * Runs shorter than this are cheaper left in a literal
+	 */
+	static const uint8_t _MIN_REPEAT = 3;
+
+	/**
+	 * Protected constructor; do not allow instatiation
+	 */
+	RunLengthEncoder();
+
+
+public:
+
+	/**
+	 * Encode len bytes of in into out and return the encoded length, or 0
+	 * if it would exceed capacity (an empty input also encodes to nothing)
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : 
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} capacity :
+	 * @return {size_t}         : encoded length
+	 */
+	static size_t encode(
+		const uint8_t* const in,
+		const size_t len,
+		uint8_t* const out,
+		const size_t capacity) noexcept;
+
+};
+
+/**
+ * Decodes run-length coded data fed in chunks of any size
+ */
+class RunLengthDecoder {
+
+protected:
+
+	//bytes still to be copied or repeated in the current run
+	uint8_t _remaining = 0;
+	uint8_t _repeat = 0;
+	bool _repeating = false;
+	bool _awaitingRepeat = false;
+
+
+public:
+
+	RunLengthDecoder() noexcept;
+
+	/**
+	 * Start a new stream
+	 */
+	void reset() noexcept;
+
+	/**
+	 * Decode from in into out until in is used up or out is full. Returns
+	 * the number of bytes written to out and sets consumed to the number
+	 * of bytes of in used; call again with the rest of in, or more of it,
+	 * to continue.
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} len       : 
+	 * @param  {size_t*} consumed : 
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} capacity  : 
+	 * @return {size_t}           : bytes written to out
+	 */
+	size_t decode(
+		const uint8_t* const in,
+		const size_t len,
+		size_t* const consumed,
+		uint8_t* const out,
+		const size_t capacity) noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,372 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#include "SampleBatchMessage.h"
+#include "Util.h"
+
+#if defined(RADIOPACKET_SAMPLES_AVX2)
+	#include <immintrin.h>
+#endif
+
+namespace RadioPacket {
+
+static uint16_t readUInt16(const uint8_t* const p) noexcept {
+	return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint8_t SampleBatchMessage::_getWidth(uint32_t v) noexcept {
+
+	uint8_t width = 0;
+
+	while(v != 0) {
+		++width;
+		v >>= 1;
+	}
+
+	return width;
+
+}
+
+void SampleBatchMessage::_repack(const uint8_t from, const uint8_t to) noexcept {
+
+	uint8_t* const deltas = this->_data.ptr(this->fromBaseBodyOffset(_DELTAS_OFFSET));
+	const uint16_t count = this->getSampleCount();
+
+	//nothing packed yet; the bits are already 0
+	if(from == 0 || count < 2) {
+		return;
+	}
+
+	//last to first, so a delta is never overwritten before it is read
+	for(size_t i = count - 1; i-- > 0; ) {
+		const uint32_t v = Util::getBits<uint32_t>(deltas, i * from, from);
+		Util::setBits(deltas, i * to, to, v);
+	}
+
+}
+
+void SampleBatchMessage::_decodeScalar(
+	const uint8_t* const deltas,
+	const uint8_t width,
+	uint16_t* const samples,
+	const uint16_t begin,
+	const uint16_t count) noexcept {
+
+		for(size_t i = begin; i < count; ++i) {
+			const uint32_t zz = Util::getBits<uint32_t>(deltas, (i - 1) * width, width);
+			samples[i] = static_cast<uint16_t>(samples[i - 1] + Util::zigzagDecode(zz));
+		}
+
+}
+
+#if defined(RADIOPACKET_SAMPLES_AVX2)
+__attribute__((target("avx2")))
+uint16_t SampleBatchMessage::_decodeAvx2(
+	const uint8_t* const deltas,
+	const size_t deltasLen,
+	const uint8_t width,
+	uint16_t* const samples,
+	const uint16_t count) noexcept {
+
+		const __m256i lanes = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+		const __m256i widths = _mm256_set1_epi32(width);
+		const __m256i seven = _mm256_set1_epi32(7);
+		const __m256i one = _mm256_set1_epi32(1);
+		const __m128i right = _mm_cvtsi32_si128(32 - width);
+
+		//big-endian words to little-endian
+		const __m256i swap = _mm256_setr_epi8(
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12,
+			3, 2, 1, 0, 7, 6, 5, 4, 11, 10, 9, 8, 15, 14, 13, 12);
+
+		//low 16 bits of each word into the low 8 bytes of each half
+		const __m256i narrow = _mm256_setr_epi8(
+			0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1,
+			0, 1, 4, 5, 8, 9, 12, 13, -1, -1, -1, -1, -1, -1, -1, -1);
+
+		__m256i carry = _mm256_set1_epi32(samples[0]);
+		size_t i = 0;
+
+		//delta i is bits [i * width, (i + 1) * width), at most 24 bits
+		//from the byte it starts in, so a 4 byte gather from there holds it
+		while(i + 8 < count && ((i + 7) * width) / 8 + 4 <= deltasLen) {
+
+			const __m256i pos = _mm256_mullo_epi32(
+				_mm256_add_epi32(_mm256_set1_epi32(static_cast<int>(i)), lanes),
+				widths);
+
+			__m256i v = _mm256_i32gather_epi32(
+				reinterpret_cast<const int*>(deltas),
+				_mm256_srli_epi32(pos, 3),
+				1);
+
+			//drop the bits before the delta, then those after it
+			v = _mm256_shuffle_epi8(v, swap);
+			v = _mm256_sllv_epi32(v, _mm256_and_si256(pos, seven));
+			v = _mm256_srl_epi32(v, right);
+
+			//zigzag decode
+			v = _mm256_xor_si256(
+				_mm256_srli_epi32(v, 1),
+				_mm256_sub_epi32(_mm256_setzero_si256(), _mm256_and_si256(v, one)));
+
+			//prefix sum within each half, then carry the low half into the
+			//high half and the previous block into both
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 4));
+			v = _mm256_add_epi32(v, _mm256_slli_si256(v, 8));
+			v = _mm256_add_epi32(v, _mm256_permute2x128_si256(
+				_mm256_shuffle_epi32(v, 0xff), v, 0x08));
+			v = _mm256_add_epi32(v, carry);
+
+			carry = _mm256_permutevar8x32_epi32(v, seven);
+
+			//samples wrap at 16 bits, so the low half of each sum is enough
+			const __m256i packed = _mm256_permute4x64_epi64(
+				_mm256_shuffle_epi8(v, narrow), 0x08);
+
+			_mm_storeu_si128(
+				reinterpret_cast<__m128i*>(samples + i + 1),
+				_mm256_castsi256_si128(packed));
+
+			i += 8;
+
+		}
+
+		return static_cast<uint16_t>(i + 1);
+
+}
+
+bool SampleBatchMessage::_hasAvx2() noexcept {
+	static const bool has = __builtin_cpu_supports("avx2");
+	return has;
+}
+#endif
+
+SampleBatchMessage::SampleBatchMessage(
+	const uint16_t action,
+	const uint16_t maxBodyLength) noexcept
+		: Message(),
+		_maxBodyLength(maxBodyLength < Message::getMaxBodyLength()
+			? maxBodyLength
+			: Message::getMaxBodyLength()) {
+			this->setRawAction(action);
+			this->clear();
+}
+
+bool SampleBatchMessage::add(const uint16_t sample) noexcept {
+
+	const uint16_t count = this->getSampleCount();
+
+	if(count == 0) {
+
+		if(this->getRawBodyLength() < _BATCH_HEADER_LEN) {
+			return false;
+		}
+
+		this->_data.setUInt16(1, this->fromBaseBodyOffset(_COUNT_OFFSET));
+		this->_data.setUInt16(sample, this->fromBaseBodyOffset(_FIRST_OFFSET));
+		this->_data.setUInt16(sample, this->fromBaseBodyOffset(_LAST_OFFSET));
+
+		return true;
+
+	}
+
+	if(count == 0xffff) {
+		return false;
+	}
+
+	const uint32_t zz = Util::zigzagEncode(
+		static_cast<int32_t>(sample) - static_cast<int32_t>(this->getLastSample()));
+
+	const uint8_t oldWidth = this->getWidth();
+	const uint8_t needed = _getWidth(zz);
+	const uint8_t width = needed > oldWidth ? needed : oldWidth;
+
+	//count deltas once this sample is added
+	const uint32_t bodyLen = _BATCH_HEADER_LEN +
+		(static_cast<uint32_t>(count) * width + 7) / 8;
+
+	if(bodyLen > this->_maxBodyLength) {
+		return false;
+	}
+
+	const uint16_t oldLen = this->getRawBodyLength();
+
+	if(bodyLen > oldLen) {
+
+		this->resizeBody(static_cast<uint16_t>(bodyLen), true);
+
+		if(this->getMessageLength() != this->fromBaseBodyOffset(static_cast<uint16_t>(bodyLen))) {
+			this->setRawBodyLength(oldLen);
+			return false;
+		}
+
+		Util::zero(
+			this->_data.ptr(this->fromBaseBodyOffset(oldLen)),
+			bodyLen - oldLen);
+
+	}
+
+	if(width > oldWidth) {
+		this->_repack(oldWidth, width);
+		this->_data[this->fromBaseBodyOffset(_WIDTH_OFFSET)] = width;
+	}
+
+	Util::setBits(
+		this->_data.ptr(this->fromBaseBodyOffset(_DELTAS_OFFSET)),
+		static_cast<size_t>(count - 1) * width,
+		width,
+		zz);
+
+	this->_data.setUInt16(count + 1, this->fromBaseBodyOffset(_COUNT_OFFSET));
+	this->_data.setUInt16(sample, this->fromBaseBodyOffset(_LAST_OFFSET));
+
+	return true;
+
+}
+
+void SampleBatchMessage::clear() noexcept {
+
+	static const uint8_t emptyHeader[_BATCH_HEADER_LEN] = { 0 };
+
+	if(this->_maxBodyLength < _BATCH_HEADER_LEN) {
+		this->resizeBody(0, true);
+		return;
+	}
+
+	this->setBodyData(emptyHeader, _BATCH_HEADER_LEN);
+
+}
+
+uint16_t SampleBatchMessage::getSampleCount() const noexcept {
+	return this->getRawBodyLength() >= _BATCH_HEADER_LEN
+		? this->_data.getUInt16(this->fromBaseBodyOffset(_COUNT_OFFSET))
+		: 0;
+}
+
+uint8_t SampleBatchMessage::getWidth() const noexcept {
+	return this->getRawBodyLength() >= _BATCH_HEADER_LEN
+		? this->_data[this->fromBaseBodyOffset(_WIDTH_OFFSET)]
+		: 0;
+}
+
+uint16_t SampleBatchMessage::getFirstSample() const noexcept {
+	return this->getRawBodyLength() >= _BATCH_HEADER_LEN
+		? this->_data.getUInt16(this->fromBaseBodyOffset(_FIRST_OFFSET))
+		: 0;
+}
+
+uint16_t SampleBatchMessage::getLastSample() const noexcept {
+	return this->getRawBodyLength() >= _BATCH_HEADER_LEN
+		? this->_data.getUInt16(this->fromBaseBodyOffset(_LAST_OFFSET))
+		: 0;
+}
+
+uint16_t SampleBatchMessage::getMaxBodyLength() const noexcept {
+	return this->_maxBodyLength;
+}
+
+uint16_t SampleBatchMessage::getSampleCount(const MessageView& m) noexcept {
+
+	if(!m.isValid() || m.getRawBodyLength() < _BATCH_HEADER_LEN) {
+		return 0;
+	}
+
+	return readUInt16(m.getBodyData() + _COUNT_OFFSET);
+
+}
+
+uint8_t SampleBatchMessage::decode(
+	const MessageView& m,
+	uint16_t* const samples,
+	const uint16_t capacity,
+	uint16_t* const count) noexcept {
+
+		if(!m.isValid()) {
+			return DECODE_ERROR_MALFORMED;
+		}
+
+		return SampleBatchMessage::decode(
+			m.getBodyData(),
+			m.getRawBodyLength(),
+			samples,
+			capacity,
+			count);
+
+}
+
+uint8_t SampleBatchMessage::decode(
+	const uint8_t* const body,
+	const uint16_t len,
+	uint16_t* const samples,
+	const uint16_t capacity,
+	uint16_t* const count) noexcept {
+
+		*count = 0;
+
+		if(body == nullptr || len < _BATCH_HEADER_LEN) {
+			return DECODE_ERROR_MALFORMED;
+		}
+
+		const uint16_t n = readUInt16(body + _COUNT_OFFSET);
+		const uint8_t width = body[_WIDTH_OFFSET];
+
+		if(n == 0) {
+			return DECODE_OK;
+		}
+
+		const uint8_t* const deltas = body + _DELTAS_OFFSET;
+		const size_t deltasLen = len - _BATCH_HEADER_LEN;
+
+		if(width > _MAX_WIDTH ||
+			(static_cast<size_t>(n - 1) * width + 7) / 8 > deltasLen) {
+				return DECODE_ERROR_MALFORMED;
+		}
+
+		if(samples == nullptr || n > capacity) {
+			return DECODE_ERROR_INSUFFICIENT_CAPACITY;
+		}
+
+		uint16_t begin = 1;
+		samples[0] = readUInt16(body + _FIRST_OFFSET);
+
+#if defined(RADIOPACKET_SAMPLES_AVX2)
+		if(_hasAvx2()) {
+			begin = _decodeAvx2(deltas, deltasLen, width, samples, n);
+		}
+#endif
+
+		_decodeScalar(deltas, width, samples, begin, n);
+
+		//the deltas must sum to the last sample
+		if(samples[n - 1] != readUInt16(body + _LAST_OFFSET)) {
+			return DECODE_ERROR_MALFORMED;
+		}
+
+		*count = n;
+
+		return DECODE_OK;
+
+}
+
+};
@@ -0,0 +1,189 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef SAMPLE_BATCH_MESSAGE_H_1EFC3C2C_55B3_4649_9CB3_D3ED8B9B85DA
+#define SAMPLE_BATCH_MESSAGE_H_1EFC3C2C_55B3_4649_9CB3_D3ED8B9B85DA
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "Message.h"
+#include "MessageView.h"
+#include "PacketEncoder.h"
+
+/**
+ * A SampleBatchMessage carries a series of 16 bit readings in one
+ * Message, rather than one Message per reading. The first reading is sent
+ * as it is and every later one as the difference from the one before,
+ * zigzag coded and packed into just enough bits for the largest
+ * difference in the batch. Readings which change slowly cost a few bits
+ * each.
+ *
+ * Body format:
+ *
+ * 	HEADER	| 0x0 - 0x1		[ COUNT, 2 bytes, unsigned ]
+ * 			| 0x2			[ WIDTH, 1 byte, unsigned, 0 - 17 ]
+ * 			| 0x3 - 0x4		[ FIRST, 2 bytes, unsigned ]
+ * 			| 0x5 - 0x6		[ LAST, 2 bytes, unsigned ]
+ * 	DELTAS	| 0x7 -			[ COUNT - 1 deltas, WIDTH bits each ]
+ *
+ * Deltas are packed most significant bit first; unused bits of the last
+ * byte are 0. LAST lets a batch be appended to without decoding it and
+ * is checked by the decoder.
+ *
+ * The width only ever grows as samples are added. When it does, the
+ * deltas already packed are widened in place, so adding needs no RAM
+ * beyond the Message.
+ */
+namespace RadioPacket {
+class SampleBatchMessage : public Message {
+
+protected:
+
+	static const uint8_t _COUNT_OFFSET = 0x0;
+	static const uint8_t _WIDTH_OFFSET = 0x2;
+	static const uint8_t _FIRST_OFFSET = 0x3;
+	static const uint8_t _LAST_OFFSET = 0x5;
+	static const uint8_t _DELTAS_OFFSET = 0x7;
+	static const uint8_t _BATCH_HEADER_LEN = 7;
+
+	//a difference between two 16 bit samples, zigzag coded
+	static const uint8_t _MAX_WIDTH = 17;
+
+	uint16_t _maxBodyLength;
+
+	static uint8_t _getWidth(uint32_t v) noexcept;
+
+	/**
+	 * Widen the packed deltas from one width to a larger one
+	 * @param  {uint8_t} from : 
+	 * @param  {uint8_t} to   : 
+	 */
+	void _repack(const uint8_t from, const uint8_t to) noexcept;
+
+	/**
+	 * Expand samples from begin up to count, each from the one before
+	 */
+	static void _decodeScalar(
+		const uint8_t* const deltas,
+		const uint8_t width,
+		uint16_t* const samples,
+		const uint16_t begin,
+		const uint16_t count) noexcept;
+
+#if defined(RADIOPACKET_SAMPLES_AVX2)
+	/**
+	 * Expand samples eight at a time while the gathers stay within
+	 * deltasLen, starting from samples[0]. Returns the index of the first
+	 * sample left for _decodeScalar.
+	 */
+	static uint16_t _decodeAvx2(
+		const uint8_t* const deltas,
+		const size_t deltasLen,
+		const uint8_t width,
+		uint16_t* const samples,
+		const uint16_t count) noexcept;
+
+	static bool _hasAvx2() noexcept;
+#endif
+
+
+public:
+
+	static const uint8_t DECODE_OK = 0;
+	static const uint8_t DECODE_ERROR_MALFORMED = 1;
+	static const uint8_t DECODE_ERROR_INSUFFICIENT_CAPACITY = 2;
+
+	/**
+	 * @param  {uint16_t} action        : 
+	 * @param  {uint16_t} maxBodyLength : largest body the batch may grow
+	 *                                    to; by default as much as fits in
+	 *                                    a single version 1 packet
+	 */
+	SampleBatchMessage(
+		const uint16_t action,
+		const uint16_t maxBodyLength = PacketEncoder::getMaxPayloadLength()) noexcept;
+
+	/**
+	 * Append a sample. Returns false, leaving the batch as it was, if the
+	 * body would exceed the maximum length; send the batch, clear() it and
+	 * add the sample again.
+	 * @param  {uint16_t} sample : 
+	 * @return {bool}            : 
+	 */
+	bool add(const uint16_t sample) noexcept;
+
+	/**
+	 * Remove all samples; the action is kept
+	 */
+	void clear() noexcept;
+
+	uint16_t getSampleCount() const noexcept;
+	uint8_t getWidth() const noexcept;
+	uint16_t getFirstSample() const noexcept;
+	uint16_t getLastSample() const noexcept;
+	uint16_t getMaxBodyLength() const noexcept;
+
+	/**
+	 * Number of samples in a received batch, or 0 if the body is too
+	 * short to be one
+	 * @param  {MessageView} m : 
+	 * @return {uint16_t}      : 
+	 */
+	static uint16_t getSampleCount(const MessageView& m) noexcept;
+
+	/**
+	 * Expand a received batch into samples. On x86-64 hosts with AVX2
+	 * eight deltas are unpacked and summed at a time.
+	 * @param  {MessageView} m          : 
+	 * @param  {uint16_t*} const        : 
+	 * @param  {uint16_t} capacity      : length of samples
+	 * @param  {uint16_t*} const count  : number of samples written
+	 * @return {uint8_t}                : one of DECODE_*
+	 */
+	static uint8_t decode(
+		const MessageView& m,
+		uint16_t* const samples,
+		const uint16_t capacity,
+		uint16_t* const count) noexcept;
+
+	/**
+	 * Expand a batch body, eg. one held by a Message
+	 * @param  {uint8_t*} const         : 
+	 * @param  {uint16_t} len           : 
+	 * @param  {uint16_t*} const        : 
+	 * @param  {uint16_t} capacity      : 
+	 * @param  {uint16_t*} const count  : 
+	 * @return {uint8_t}                : one of DECODE_*
+	 */
+	static uint8_t decode(
+		const uint8_t* const body,
+		const uint16_t len,
+		uint16_t* const samples,
+		const uint16_t capacity,
+		uint16_t* const count) noexcept;
+
+};
+};
+
+#endif
@@ -0,0 +1,259 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+#ifndef STORAGE_H_F98EB5E0_15AE_4DD7_AF2F_30DC2D2026BB
+#define STORAGE_H_F98EB5E0_15AE_4DD7_AF2F_30DC2D2026BB
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Allocator.h"
+#include "Util.h"
+
+/**
+ * Storage policies for ExpandingArray.
+ *
+ * A policy provides a nested Buffer<StorageType, IndexType> template which
+ * owns the underlying contiguous array. ExpandingArray tracks how much of
+ * the array is in use; the Buffer only decides where the array lives, how
+ * large it may become and how quickly it grows.
+ */
+namespace RadioPacket {
+
+/**
+ * Array is allocated through Allocator and may grow to any length. Growth
+ * is geometric so repeated appends reallocate O(log n) times. Elements are
+ * not constructed, so StorageType must be trivial.
+ */
+template<class Allocator>
+struct AllocatedStorage {
+
+	template<class StorageType, class IndexType>
+	class Buffer {
+
+	protected:
+
+		StorageType* _data = nullptr;
+		IndexType _capacity = 0;
+
+	public:
+
+		Buffer() noexcept = default;
+
+		/**
+		 * Copying is ExpandingArray's responsibility; a Buffer copy would
+		 * share the array
+		 */
+		Buffer(const Buffer& b) = delete;
+		Buffer& operator=(const Buffer& b) = delete;
+
+		StorageType* data() noexcept {
+			return this->_data;
+		}
+
+		const StorageType* data() const noexcept {
+			return this->_data;
+		}
+
+		IndexType capacity() const noexcept {
+			return this->_capacity;
+		}
+
+		/**
+		 * Returns the capacity to allocate in order to hold len elements;
+		 * double the current capacity, saturating at the largest length
+		 * IndexType can represent
+		 */
+		IndexType grow(const IndexType len) const noexcept {
+
+			const IndexType maxLen = static_cast<IndexType>(~static_cast<IndexType>(0));
+			const IndexType doubled = this->_capacity > maxLen / 2
+				? maxLen
+				: this->_capacity * 2;
+
+			return doubled > len ? doubled : len;
+
+		}
+
+		/**
+		 * Take ownership of b's array, leaving b empty. used is the number
+		 * of elements in use in b.
+		 */
+		void take(Buffer& b, const IndexType) noexcept {
+
+			this->release();
+
+			this->_data = b._data;
+			this->_capacity = b._capacity;
+
+			b._data = nullptr;
+			b._capacity = 0;
+
+		}
+
+		/**
+		 * Replace the underlying array with one holding len elements,
+		 * keeping the first keep elements. Returns false if the array
+		 * cannot hold len elements.
+		 *
+		 * If zero is true, the to-be-deallocated array is zero'd-out
+		 * before being deleted
+		 */
+		bool reallocate(const IndexType len, const IndexType keep, const bool zero) noexcept {
+
+			StorageType* arr;
+
+			//the old array must outlive the new one to be zero'd-out, so
+			//only hand it to the allocator to resize when not zeroing
+			if(this->_data != nullptr && !zero) {
+
+				arr = static_cast<StorageType*>(Allocator::reallocate(
+					this->_data,
+					this->_capacity * sizeof(StorageType),
+					len * sizeof(StorageType),
+					keep * sizeof(StorageType)));
+
+				if(arr == nullptr) {
+					return false;
+				}
+
+			}
+			else {
+
+				//no need to initialise the elements
+				arr = static_cast<StorageType*>(Allocator::allocate(len * sizeof(StorageType)));
+
+				if(arr == nullptr) {
+					return false;
+				}
+
+				if(keep > 0 && this->_data != nullptr) {
+					::memcpy(arr, this->_data, keep * sizeof(StorageType));
+				}
+
+				this->release(zero);
+
+			}
+
+			this->_data = arr;
+			this->_capacity = len;
+
+			return true;
+
+		}
+
+		/**
+		 * Deallocate the underlying array
+		 */
+		void release(const bool zero = false) noexcept {
+
+			if(zero && this->_data != nullptr) {
+				Util::zero(this->_data, this->_capacity * sizeof(StorageType));
+			}
+
+			Allocator::deallocate(this->_data, this->_capacity * sizeof(StorageType));
+
+			this->_data = nullptr;
+			this->_capacity = 0;
+
+		}
+
+	};
+
+};
+
+/**
+ * Array is allocated on the heap through RADIOPACKET_ALLOCATOR(HeapStorage)
+ */
+struct HeapStorage : AllocatedStorage<RADIOPACKET_ALLOCATOR(HeapStorage)> {
+};
+
+/**
+ * Array is held inline in a fixed-size buffer of N elements; it is never
+ * allocated, deallocated or moved, and can never grow beyond N
+ */
+template<size_t N>
+struct InlineStorage {
+
+	static_assert(N > 0, "InlineStorage must hold at least one element");
+
+	template<class StorageType, class IndexType>
+	class Buffer {
+
+		static_assert(N <= static_cast<IndexType>(~static_cast<IndexType>(0)),
+			"InlineStorage capacity must be addressable by IndexType");
+
+	protected:
+
+		StorageType _data[N];
+
+	public:
+
+		StorageType* data() noexcept {
+			return this->_data;
+		}
+
+		const StorageType* data() const noexcept {
+			return this->_data;
+		}
+
+		IndexType capacity() const noexcept {
+			return N;
+		}
+
+		/**
+		 * The array cannot grow beyond N, so only ever ask for len
+		 */
+		IndexType grow(const IndexType len) const noexcept {
+			return len;
+		}
+
+		/**
+		 * Copy the used elements of b's array; an inline array cannot change
+		 * hands
+		 */
+		void take(Buffer& b, const IndexType used) noexcept {
+			::memcpy(this->_data, b._data, used * sizeof(StorageType));
+		}
+
+		/**
+		 * The array never moves, so existing elements are always kept.
+		 * Returns false if len exceeds N.
+		 */
+		bool reallocate(const IndexType len, const IndexType, const bool) noexcept {
+			return len <= N;
+		}
+
+		void release(const bool zero = false) noexcept {
+			if(zero) {
+				Util::zero(this->_data, N * sizeof(StorageType));
+			}
+		}
+
+	};
+
+};
+
+};
+
+#endif
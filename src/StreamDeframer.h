@@ -0,0 +1,264 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef STREAM_DEFRAMER_H_6B25CC35_8286_4C35_ABF6_0A0C3576C069
+#define STREAM_DEFRAMER_H_6B25CC35_8286_4C35_ABF6_0A0C3576C069
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "RadioPacket.h"
+#include "RadioPacketView.h"
+
+/**
+ * A StreamDeframer finds packets in a continuous stream of bytes with no
+ * framing, such as a serial bridge, where packets arrive back-to-back and
+ * may be separated by noise.
+ *
+ * Bytes are written in chunks of any size into a ring buffer of Capacity
+ * bytes. next() then scans for a packet start, where:
+ *
+ * 	- the version is known
+ * 	- the packet length is at least that version's header length
+ * 	- the body length agrees with the packet length, where the version
+ * 	  carries one
+ * 	- the CRC8 matches
+ *
+ * If a candidate fails any of these checks, one byte is skipped and the
+ * scan resumes from the next byte, so the deframer resynchronises after
+ * any amount of garbage. The cheap header checks reject almost all
+ * garbage before a CRC is calculated. Version 3 headers have no body
+ * length to check, so garbage which looks like one is caught only by
+ * the CRC8.
+ *
+ * The first RadioPacket::getMaxPacketLength() bytes of the ring are
+ * mirrored past its end, so a packet which wraps around the end of the
+ * ring is still contiguous in memory and can be returned as a view
+ * without being copied.
+ *
+ * 	StreamDeframer<1024> d;
+ * 	RadioPacketView p;
+ *
+ * 	d.write(chunk, chunkLen);
+ *
+ * 	while(d.next(&p)) {
+ * 		//use p
+ * 	}
+ */
+namespace RadioPacket {
+
+template<size_t Capacity>
+class StreamDeframer {
+
+	static_assert(Capacity >= RadioPacket::getMaxPacketLength(),
+		"StreamDeframer must be able to hold the longest packet");
+	static_assert((Capacity & (Capacity - 1)) == 0,
+		"StreamDeframer capacity must be a power of 2");
+
+protected:
+
+	static const size_t _MIRROR_LEN = RadioPacket::getMaxPacketLength();
+
+	uint8_t _buff[Capacity + _MIRROR_LEN];
+	size_t _head = 0;
+	size_t _size = 0;
+
+	uint32_t _frames = 0;
+	uint32_t _skipped = 0;
+	uint32_t _checksumErrors = 0;
+	uint32_t _dropped = 0;
+
+	/**
+	 * Copy len bytes into the ring at index i, where they do not wrap
+	 */
+	void _store(const size_t i, const uint8_t* const data, const size_t len) noexcept {
+
+		::memcpy(&this->_buff[i], data, len);
+
+		if(i < _MIRROR_LEN) {
+			const size_t mirrored = len < _MIRROR_LEN - i ? len : _MIRROR_LEN - i;
+			::memcpy(&this->_buff[Capacity + i], data, mirrored);
+		}
+
+	}
+
+	void _consume(const size_t len) noexcept {
+		this->_head = (this->_head + len) & (Capacity - 1);
+		this->_size -= len;
+	}
+
+
+
+public:
+
+	StreamDeframer() noexcept {
+	}
+
+	StreamDeframer(const StreamDeframer& d) = delete;
+	StreamDeframer& operator=(const StreamDeframer& d) = delete;
+
+	/**
+	 * Append len bytes to the stream. Returns the number of bytes written,
+	 * which is less than len if the ring is full; the remainder are
+	 * dropped. Any view returned by next() is invalidated.
+	 * @param  {uint8_t*} const :
+	 * @param  {size_t} len     :
+	 * @return {size_t}         : number of bytes written
+	 */
+	size_t write(const uint8_t* const data, const size_t len) noexcept {
+
+		const size_t space = Capacity - this->_size;
+		const size_t n = len < space ? len : space;
+		const size_t tail = (this->_head + this->_size) & (Capacity - 1);
+		const size_t first = n < Capacity - tail ? n : Capacity - tail;
+
+		this->_store(tail, data, first);
+		this->_store(0, data + first, n - first);
+
+		this->_size += n;
+		this->_dropped += len - n;
+
+		return n;
+
+	}
+
+	/**
+	 * Find the next packet in the stream and point v at it. Returns false
+	 * if no complete packet is available yet, in which case write more
+	 * bytes and call again. v remains valid until write is next called.
+	 * @param  {RadioPacketView*} const :
+	 * @return {bool}                   :
+	 */
+	bool next(RadioPacketView* const v) noexcept {
+
+		while(this->_size > RadioPacket::_VERSION_OFFSET) {
+
+			const uint8_t* const p = &this->_buff[this->_head];
+			const uint8_t len = p[RadioPacket::_PACKETLEN_OFFSET];
+			const PacketFormat* const format = KnownPacketLayouts::find(
+				p[RadioPacket::_VERSION_OFFSET]);
+
+			if(format == nullptr || len < format->headerLength) {
+				++this->_skipped;
+				this->_consume(1);
+				continue;
+			}
+
+			//the rest of the header may not have arrived yet
+			if(this->_size < format->headerLength) {
+				return false;
+			}
+
+			if(format->hasBodyLength() && p[format->bodyLengthOffset] != len - format->headerLength) {
+				++this->_skipped;
+				this->_consume(1);
+				continue;
+			}
+
+			//plausible header; wait for the rest of the packet
+			if(this->_size < len) {
+				return false;
+			}
+
+			RadioPacketView::parse(v, p, len);
+
+			if(v->generateChecksum() != v->getRawCrc8()) {
+				++this->_checksumErrors;
+				++this->_skipped;
+				this->_consume(1);
+				continue;
+			}
+
+			++this->_frames;
+			this->_consume(len);
+
+			return true;
+
+		}
+
+		return false;
+
+	}
+
+	/**
+	 * Discard everything in the ring
+	 */
+	void clear() noexcept {
+		this->_head = 0;
+		this->_size = 0;
+	}
+
+	/**
+	 * Number of bytes waiting to be deframed
+	 * @return {size_t}  :
+	 */
+	size_t size() const noexcept {
+		return this->_size;
+	}
+
+	/**
+	 * Number of bytes which can be written before the ring is full
+	 * @return {size_t}  :
+	 */
+	size_t available() const noexcept {
+		return Capacity - this->_size;
+	}
+
+	/**
+	 * Number of packets found
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getFrameCount() const noexcept {
+		return this->_frames;
+	}
+
+	/**
+	 * Number of bytes skipped while resynchronising
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getSkippedByteCount() const noexcept {
+		return this->_skipped;
+	}
+
+	/**
+	 * Number of plausible packet headers rejected by their CRC8
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getChecksumErrorCount() const noexcept {
+		return this->_checksumErrors;
+	}
+
+	/**
+	 * Number of bytes dropped because the ring was full
+	 * @return {uint32_t}  :
+	 */
+	uint32_t getDroppedByteCount() const noexcept {
+		return this->_dropped;
+	}
+
+};
+
+};
+
+#endif
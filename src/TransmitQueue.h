@@ -0,0 +1,323 @@
+// MIT License
+//
+// Copyright (c) 2021 Daniel Robertson
+//
+// Permission is hereby granted, free of charge, to any person obtaining a copy
+// of this software and associated documentation files (the "Software"), to deal
+// in the Software without restriction, including without limitation the rights
+// to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+// copies of the Software, and to permit persons to whom the Software is
+// furnished to do so, subject to the following conditions:
+//
+// The above copyright notice and this permission notice shall be included in all
+// copies or substantial portions of the Software.
+//
+// THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+// IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+// FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+// AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+// LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+// OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+// SOFTWARE.
+
+
+#ifndef TRANSMIT_QUEUE_H_1F4E77BE_89D7_49BD_A7EB_44A52E1892FE
+#define TRANSMIT_QUEUE_H_1F4E77BE_89D7_49BD_A7EB_44A52E1892FE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "Atomic.h"
+#include "Meta.h"
+#include "Platform.h"
+#include "RadioPacket.h"
+
+/**
+ * Lock-free multi-producer, single-consumer queue of encoded frames with
+ * Priorities levels; level 0 is the most urgent.
+ *
+ * Any number of producers (threads, ISRs, timers) push frames without
+ * ever waiting on the radio; a push only fails if its level is full. A
+ * single writer drains the queue in batches, most urgent frames first,
+ * transmits them and then releases the batch.
+ *
+ * 	q.push(priority, frame, len);					//any producer
+ *
+ * 	TransmitFrame batch[8];							//the writer
+ * 	const size_t n = q.next(batch, 8);
+ *
+ * 	for(size_t i = 0; i < n; ++i) {
+ * 		transmit(batch[i].data, batch[i].length);
+ * 	}
+ *
+ * 	q.release();
+ *
+ * Each level is a bounded ring of Slots frame slots in which a slot's
+ * sequence number tells producers and the writer whose turn it is
+ * (Vyukov's bounded queue). Frames within a level are sent in the order
+ * their slots were claimed. A lower level is only sent once every higher
+ * level is empty, so constant urgent traffic starves bulk traffic.
+ */
+namespace RadioPacket {
+
+/**
+ * A frame handed to the writer by TransmitQueue::next
+ */
+struct TransmitFrame {
+	const uint8_t* data;
+	size_t length;
+	uint8_t priority;
+};
+
+template<size_t Slots, uint8_t Priorities = 2, size_t SlotSize = RadioPacket::getMaxPacketLength()>
+class TransmitQueue {
+
+	static_assert(Slots > 0 && (Slots & (Slots - 1)) == 0,
+		"TransmitQueue slot count must be a power of 2");
+	static_assert(Priorities > 0, "TransmitQueue needs at least one priority level");
+	static_assert(SlotSize > 0, "TransmitQueue slots must hold at least one byte");
+
+protected:
+
+	typedef typename Meta::Conditional<(SlotSize <= 0xff), uint8_t,
+		typename Meta::Conditional<(SlotSize <= 0xffff), uint16_t, size_t>::Type>::Type LengthType;
+
+	struct Cell {
+		Atomic<size_t> sequence;
+		LengthType length;
+		uint8_t data[SlotSize];
+	};
+
+	struct Level {
+		RADIOPACKET_CACHE_ALIGNED Atomic<size_t> enqueue;
+		Atomic<uint32_t> overruns;
+		Cell cells[Slots];
+	};
+
+	Level _levels[Priorities];
+
+	/**
+	 * Owned by the writer: the next slot to read in each level, and how
+	 * many slots of each level the last batch holds
+	 */
+	RADIOPACKET_CACHE_ALIGNED size_t _dequeue[Priorities];
+	size_t _pending[Priorities];
+
+
+public:
+
+	/**
+	 * A slot reserved by claim. It must be committed, even if empty; the
+	 * writer cannot pass an uncommitted slot.
+	 */
+	class Reservation {
+
+		friend class TransmitQueue;
+
+	protected:
+
+		Cell* _cell = nullptr;
+		size_t _position = 0;
+
+	public:
+
+		uint8_t* data() const noexcept {
+			return this->_cell->data;
+		}
+
+		explicit operator bool() const noexcept {
+			return this->_cell != nullptr;
+		}
+
+	};
+
+	TransmitQueue() noexcept {
+
+		for(uint8_t p = 0; p < Priorities; ++p) {
+
+			this->_levels[p].enqueue.store(0);
+			this->_levels[p].overruns.store(0);
+
+			for(size_t i = 0; i < Slots; ++i) {
+				this->_levels[p].cells[i].sequence.store(i);
+			}
+
+			this->_dequeue[p] = 0;
+			this->_pending[p] = 0;
+
+		}
+
+	}
+
+	TransmitQueue(const TransmitQueue& q) = delete;
+	TransmitQueue& operator=(const TransmitQueue& q) = delete;
+
+	static constexpr size_t capacity() noexcept {
+		return Slots * Priorities;
+	}
+
+	static constexpr size_t getSlotSize() noexcept {
+		return SlotSize;
+	}
+
+	static constexpr uint8_t getPriorityCount() noexcept {
+		return Priorities;
+	}
+
+	/**
+	 * Producer: reserve a slot at the given priority to encode a frame of
+	 * up to getSlotSize() bytes directly into. Returns false if that level
+	 * is full (or priority is out of range).
+	 * @param  {uint8_t} priority       : 0 is the most urgent
+	 * @param  {Reservation*} const     :
+	 * @return {bool}                   :
+	 */
+	bool claim(const uint8_t priority, Reservation* const r) noexcept {
+
+		if(priority >= Priorities) {
+			return false;
+		}
+
+		Level& level = this->_levels[priority];
+		size_t pos = level.enqueue.loadRelaxed();
+
+		for(;;) {
+
+			Cell* const cell = &level.cells[pos & (Slots - 1)];
+			const ptrdiff_t diff = static_cast<ptrdiff_t>(cell->sequence.load() - pos);
+
+			if(diff == 0) {
+				//the slot is free; race other producers for it
+				if(level.enqueue.compareExchangeWeak(pos, pos + 1)) {
+					r->_cell = cell;
+					r->_position = pos;
+					return true;
+				}
+			}
+			else if(diff < 0) {
+				//the writer has not released this slot yet
+				level.overruns.fetchAdd(1);
+				return false;
+			}
+			else {
+				//another producer took it first
+				pos = level.enqueue.loadRelaxed();
+			}
+
+		}
+
+	}
+
+	/**
+	 * Producer: publish the frame of len bytes written to a claimed slot
+	 * @param  {Reservation&} r :
+	 * @param  {size_t} len     : at most getSlotSize()
+	 */
+	void commit(Reservation& r, const size_t len) noexcept {
+
+		r._cell->length = static_cast<LengthType>(len < SlotSize ? len : SlotSize);
+		r._cell->sequence.store(r._position + 1);
+
+		r._cell = nullptr;
+
+	}
+
+	/**
+	 * Producer: copy a frame into the queue at the given priority.
+	 * Returns false if it does not fit or that level is full.
+	 * @param  {uint8_t} priority : 0 is the most urgent
+	 * @param  {uint8_t*} const   :
+	 * @param  {size_t} len       :
+	 * @return {bool}             :
+	 */
+	bool push(const uint8_t priority, const uint8_t* const frame, const size_t len) noexcept {
+
+		Reservation r;
+
+		if(len > SlotSize || !this->claim(priority, &r)) {
+			return false;
+		}
+
+		::memcpy(r.data(), frame, len);
+		this->commit(r, len);
+
+		return true;
+
+	}
+
+	/**
+	 * Writer: fill frames with up to max committed frames, most urgent
+	 * first, and return how many. The frames stay in place, and are not
+	 * returned again, until release is called.
+	 * @param  {TransmitFrame*} const :
+	 * @param  {size_t} max           :
+	 * @return {size_t}               :
+	 */
+	size_t next(TransmitFrame* const frames, const size_t max) noexcept {
+
+		size_t n = 0;
+
+		for(uint8_t p = 0; p < Priorities && n < max; ++p) {
+
+			Level& level = this->_levels[p];
+
+			while(n < max) {
+
+				const size_t pos = this->_dequeue[p] + this->_pending[p];
+				const Cell& cell = level.cells[pos & (Slots - 1)];
+
+				if(cell.sequence.load() != pos + 1) {
+					break;
+				}
+
+				frames[n].data = cell.data;
+				frames[n].length = cell.length;
+				frames[n].priority = p;
+
+				++this->_pending[p];
+				++n;
+
+			}
+
+		}
+
+		return n;
+
+	}
+
+	/**
+	 * Writer: hand every slot returned by next since the last release
+	 * back to the producers
+	 */
+	void release() noexcept {
+
+		for(uint8_t p = 0; p < Priorities; ++p) {
+
+			Level& level = this->_levels[p];
+
+			for(; this->_pending[p] > 0; --this->_pending[p]) {
+				const size_t pos = this->_dequeue[p]++;
+				level.cells[pos & (Slots - 1)].sequence.store(pos + Slots);
+			}
+
+		}
+
+	}
+
+	/**
+	 * Number of times a producer found the given level full
+	 * @param  {uint8_t} priority :
+	 * @return {uint32_t}         :
+	 */
+	uint32_t getOverrunCount(const uint8_t priority) const noexcept {
+		return priority < Priorities
+			? this->_levels[priority].overruns.load()
+			: 0;
+	}
+
+};
+
+};
+
+#endif
@@ -28,16 +28,14 @@
 #include <stdint.h>
 #include <string.h>
 
+#include "Meta.h"
+#include "Platform.h"
+
 namespace RadioPacket {
 class Util {
 
 protected:
 
-	/**
-	 * https://stackoverflow.com/a/15171925/570787
-	 */
-	static const uint8_t crc8_table[256];
-
 	/**
 	 * Protected constructor; do not allow instatiation
 	 */
@@ -47,15 +45,62 @@ protected:
 public:
 
 	/**
-	 * Converts a short (uint16_t) from host byte order to network byte order
+	 * Reverses the byte order of a short (uint16_t)
 	 * @param  {uint16_t} s : 
 	 * @return {uint16_t}   : 
 	 */
-	static inline uint16_t htons(const uint16_t s) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-			return __builtin_bswap16(s);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-			return s;
+	static inline uint16_t bswap16(const uint16_t s) {
+#if defined(__GNUC__)
+		return __builtin_bswap16(s);
+#else
+		return static_cast<uint16_t>((s << 8) | (s >> 8));
+#endif
+	}
+
+	/**
+	 * Reverses the byte order of a long (uint32_t)
+	 * @param  {uint32_t} l : 
+	 * @return {uint32_t}   : 
+	 */
+	static inline uint32_t bswap32(const uint32_t l) {
+#if defined(__GNUC__)
+		return __builtin_bswap32(l);
+#else
+		return (static_cast<uint32_t>(Util::bswap16(static_cast<uint16_t>(l))) << 16) |
+			Util::bswap16(static_cast<uint16_t>(l >> 16));
+#endif
+	}
+
+	/**
+	 * Reverses the byte order of a long long (uint64_t)
+	 * @param  {uint64_t} ll : 
+	 * @return {uint64_t}    : 
+	 */
+	static inline uint64_t bswap64(const uint64_t ll) {
+#if defined(__GNUC__)
+		return __builtin_bswap64(ll);
+#else
+		return (static_cast<uint64_t>(Util::bswap32(static_cast<uint32_t>(ll))) << 32) |
+			Util::bswap32(static_cast<uint32_t>(ll >> 32));
+#endif
+	}
+
+	/*
+	 * glibc defines htons and friends as macros when optimising, so these
+	 * names are parenthesised, here and at call sites, to keep them from
+	 * being expanded when <arpa/inet.h> is included first
+	 */
+
+	/**
+	 * Converts a short (uint16_t) from host byte order to network byte order
+	 * @param  {uint16_t} s :
+	 * @return {uint16_t}   : 
+	 */
+	static inline uint16_t (htons)(const uint16_t s) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap16(s);
+#else
+		return s;
 #endif
 	}
 	
@@ -64,11 +109,11 @@ public:
 	 * @param  {uint16_t} s : 
 	 * @return {uint16_t}   : 
 	 */
-	static inline uint16_t ntohs(const uint16_t s) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-			return __builtin_bswap16(s);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-			return s;
+	static inline uint16_t (ntohs)(const uint16_t s) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap16(s);
+#else
+		return s;
 #endif
 	}
 
@@ -77,10 +122,10 @@ public:
 	 * @param  {uint32_t} l : 
 	 * @return {uint32_t}   : 
 	 */
-	static inline uint32_t htonl(const uint32_t l) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-		return __builtin_bswap32(l);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	static inline uint32_t (htonl)(const uint32_t l) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap32(l);
+#else
 		return l;
 #endif
 	}
@@ -90,10 +135,10 @@ public:
 	 * @param  {uint32_t} l : 
 	 * @return {uint32_t}   : 
 	 */
-	static inline uint32_t ntohl(const uint32_t l) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-		return __builtin_bswap32(l);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	static inline uint32_t (ntohl)(const uint32_t l) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap32(l);
+#else
 		return l;
 #endif
 	}
@@ -103,11 +148,11 @@ public:
 	 * @param  {uint64_t} ll : 
 	 * @return {uint64_t}    : 
 	 */
-	static inline uint64_t htonll(const uint64_t ll) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-		return __builtin_bswap64(ll);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
-		return l;
+	static inline uint64_t (htonll)(const uint64_t ll) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap64(ll);
+#else
+		return ll;
 #endif
 	}
 
@@ -116,14 +161,199 @@ public:
 	 * @param  {uint64_t} ll : 
 	 * @return {uint64_t}    : 
 	 */
-	static inline uint64_t ntohll(const uint64_t ll) {
-#if __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
-		return __builtin_bswap64(ll);
-#elif __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+	static inline uint64_t (ntohll)(const uint64_t ll) {
+#if defined(RADIOPACKET_LITTLE_ENDIAN)
+		return Util::bswap64(ll);
+#else
 		return ll;
 #endif
 	}
 
+	/**
+	 * Maps a signed integer onto an unsigned one of the same width so that
+	 * values near zero, of either sign, stay small: 0, -1, 1, -2, 2, ...
+	 * become 0, 1, 2, 3, 4, ... Used before varint coding signed values.
+	 * @param  {T} v : 
+	 * @return {U}   : 
+	 */
+	template<class T>
+	static constexpr typename Meta::MakeUnsigned<T>::Type zigzagEncode(const T v) noexcept {
+		typedef typename Meta::MakeUnsigned<T>::Type U;
+		return static_cast<U>(
+			static_cast<U>(static_cast<U>(v) << 1) ^
+			static_cast<U>(-static_cast<U>(static_cast<U>(v) >> (sizeof(T) * 8 - 1))));
+	}
+
+	/**
+	 * Inverse of zigzagEncode
+	 * @param  {U} u : 
+	 * @return {T}   : 
+	 */
+	template<class U>
+	static constexpr typename Meta::MakeSigned<U>::Type zigzagDecode(const U u) noexcept {
+		typedef typename Meta::MakeSigned<U>::Type T;
+		return static_cast<T>(static_cast<U>(
+			static_cast<U>(u >> 1) ^ static_cast<U>(-static_cast<U>(u & 1))));
+	}
+
+	/**
+	 * Number of bytes v takes as an unsigned LEB128 varint
+	 * @param  {T} v      : 
+	 * @return {uint8_t}  : 
+	 */
+	template<class T>
+	static constexpr uint8_t getVarintLength(const T v) noexcept {
+		return v < 0x80 ? 1 : 1 + Util::getVarintLength<T>(static_cast<T>(v >> 7));
+	}
+
+	/**
+	 * Write an unsigned integer as an LEB128 varint: 7 bits per byte,
+	 * least significant first, with the top bit set on all but the last
+	 * byte. Returns the number of bytes written, or 0 if len is too short.
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : 
+	 * @param  {T} v            : 
+	 * @return {uint8_t}        : bytes written
+	 */
+	template<class T>
+	static inline uint8_t encodeVarint(uint8_t* const buff, const size_t len, T v) noexcept {
+
+		uint8_t n = 0;
+
+		do {
+
+			if(n == len) {
+				return 0;
+			}
+
+			const uint8_t b = static_cast<uint8_t>(v & 0x7f);
+			v = static_cast<T>(v >> 7);
+			buff[n++] = v != 0 ? static_cast<uint8_t>(b | 0x80) : b;
+
+		} while(v != 0);
+
+		return n;
+
+	}
+
+	/**
+	 * Read an LEB128 varint into v. Returns the number of bytes read, or 0
+	 * if the varint is cut short by len or does not fit in T.
+	 * @param  {uint8_t*} const : 
+	 * @param  {size_t} len     : 
+	 * @param  {T*} const       : 
+	 * @return {uint8_t}        : bytes read
+	 */
+	template<class T>
+	static inline uint8_t decodeVarint(const uint8_t* const buff, const size_t len, T* const v) noexcept {
+
+		const uint8_t bits = sizeof(T) * 8;
+		T result = 0;
+		uint8_t shift = 0;
+
+		for(uint8_t n = 0; n < len && shift < bits; ++n, shift += 7) {
+
+			const uint8_t b = buff[n] & 0x7f;
+
+			//bits which would be shifted out of T
+			if(bits - shift < 7 && (b >> (bits - shift)) != 0) {
+				return 0;
+			}
+
+			result = static_cast<T>(result | (static_cast<T>(b) << shift));
+
+			if((buff[n] & 0x80) == 0) {
+				*v = result;
+				return n + 1;
+			}
+
+		}
+
+		return 0;
+
+	}
+
+	/**
+	 * Write the low width bits of value into buff, starting bitOffset bits
+	 * in, most significant bit first. Bits either side are left as they
+	 * are.
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} bitOffset : 
+	 * @param  {uint8_t} width    : up to the width of T
+	 * @param  {T} value          : 
+	 */
+	template<class T>
+	static inline void setBits(
+		uint8_t* const buff,
+		size_t bitOffset,
+		uint8_t width,
+		const T value) noexcept {
+
+			while(width > 0) {
+
+				const uint8_t room = 8 - (bitOffset & 7);
+				const uint8_t n = width < room ? width : room;
+				const uint8_t shift = room - n;
+				const uint8_t mask = static_cast<uint8_t>(((1u << n) - 1) << shift);
+				const uint8_t bits = static_cast<uint8_t>(value >> (width - n));
+				uint8_t& b = buff[bitOffset >> 3];
+
+				b = static_cast<uint8_t>((b & ~mask) | ((bits << shift) & mask));
+
+				width -= n;
+				bitOffset += n;
+
+			}
+
+	}
+
+	/**
+	 * Read width bits from buff, starting bitOffset bits in, most
+	 * significant bit first
+	 * @param  {uint8_t*} const   : 
+	 * @param  {size_t} bitOffset : 
+	 * @param  {uint8_t} width    : up to the width of T
+	 * @return {T}                : 
+	 */
+	template<class T = uint32_t>
+	static inline T getBits(
+		const uint8_t* const buff,
+		size_t bitOffset,
+		uint8_t width) noexcept {
+
+			T value = 0;
+
+			while(width > 0) {
+
+				const uint8_t room = 8 - (bitOffset & 7);
+				const uint8_t n = width < room ? width : room;
+				const uint8_t bits = static_cast<uint8_t>(
+					(buff[bitOffset >> 3] >> (room - n)) & ((1u << n) - 1));
+
+				//shift in two steps; a shift by the full width of T is
+				//undefined
+				value = static_cast<T>(static_cast<T>(static_cast<T>(value << (n - 1)) << 1) | bits);
+
+				width -= n;
+				bitOffset += n;
+
+			}
+
+			return value;
+
+	}
+
+	/**
+	 * Casts t to an rvalue so it can be moved from; equivalent to std::move,
+	 * which is not available on all platforms
+	 * @param  {T&} t :
+	 * @return {T&&}  :
+	 */
+	template<class T>
+	static inline T&& move(T& t) noexcept {
+		return static_cast<T&&>(t);
+	}
+
 	/**
 	 * Zeroes an array of data by setting each element to 0
 	 * @param  {void*} const : 
@@ -136,7 +366,7 @@ public:
 	/**
 	 * Calculate the CRC8 value of data
 	 * Set data to nullptr to return the initial seed value
-	 * This is an AVR-optimised function
+	 * Uses avr-libc on AVR and the table-driven Crc8Ccitt engine elsewhere
 	 * https://www.nongnu.org/avr-libc/user-manual/group__util__crc.html#gab27eaaef6d7fd096bd7d57bf3f9ba083
 	 * @param  {uint8_t} crc    : 
 	 * @param  {uint8_t*} const : 
@@ -148,7 +378,7 @@ public:
 	/**
 	 * Calculate the CRC16 value of data
 	 * Set data to nullptr to return the initial seed value
-	 * This is an AVR-optimised function
+	 * Uses avr-libc on AVR and the table-driven Crc16Ccitt engine elsewhere
 	 * https://www.nongnu.org/avr-libc/user-manual/group__util__crc.html#ga1c1d3ad875310cbc58000e24d981ad20
 	 * @param  {uint16_t} crc   : 
 	 * @param  {uint8_t*} const : 
@@ -171,6 +401,7 @@ public:
 	/**
 	 * Calculate the CRC8 value of data
 	 * Set data to nullptr to return the initial seed value
+	 * Same result as crc8_slow, using the table-driven Crc8Poly4D engine
 	 * https://stackoverflow.com/a/15171925/570787
 	 * @param  {uint8_t} crc   : 
 	 * @param  {uint8_t*} data : 